@@ -0,0 +1,126 @@
+#ifndef __NX_ARENA_H__
+#define __NX_ARENA_H__
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+#include <nx/config.h>
+
+namespace nx {
+
+/// @file
+///
+/// Monotonic allocation arena
+
+/// Bump allocator releasing everything at once
+///
+/// Memory comes in chunks recycled through an object_pool, the first one
+/// is kept across reset() so a request cycle reusing the arena does not
+/// allocate. Not thread-safe.
+class NX_API arena
+{
+public:
+    static constexpr std::size_t chunk_size = 16 * 1024;
+
+    arena() = default;
+    ~arena();
+
+    arena(const arena&) = delete;
+    void operator=(const arena&) = delete;
+
+    void* allocate(std::size_t size, std::size_t align = alignof(std::max_align_t));
+
+    /// Returns storage for count trivially destructible T
+    template <typename T>
+    T* make_array(std::size_t count)
+    {
+        static_assert(
+            std::is_trivially_destructible<T>::value,
+            "arena never runs destructors"
+        );
+
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /// Frees all allocations
+    void reset();
+
+private:
+    struct chunk
+    {
+        chunk* next;
+        std::size_t size;
+    };
+
+    void add_chunk(std::size_t size);
+    void free_chunk(chunk* c);
+
+    chunk* chunks_ = nullptr;
+    char* cur_ = nullptr;
+    char* end_ = nullptr;
+};
+
+/// Allocator drawing from an arena, or from the heap when it has none
+///
+/// Containers copied or moved across allocators get their own storage, so
+/// that nothing outlives the arena by accident.
+template <typename T>
+class arena_allocator
+{
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+
+    arena_allocator() = default;
+
+    arena_allocator(arena& a)
+    : a_(&a)
+    {}
+
+    template <typename U>
+    arena_allocator(const arena_allocator<U>& other)
+    : a_(other.get_arena())
+    {}
+
+    T* allocate(std::size_t n)
+    {
+        if (a_) {
+            return static_cast<T*>(a_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        if (!a_) {
+            std::allocator<T>().deallocate(p, n);
+        }
+    }
+
+    arena_allocator select_on_container_copy_construction() const
+    { return arena_allocator(); }
+
+    arena* get_arena() const
+    { return a_; }
+
+private:
+    arena* a_ = nullptr;
+};
+
+template <typename T, typename U>
+bool
+operator==(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs)
+{ return lhs.get_arena() == rhs.get_arena(); }
+
+template <typename T, typename U>
+bool
+operator!=(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs)
+{ return !(lhs == rhs); }
+
+} // namespace nx
+
+#endif // __NX_ARENA_H__
@@ -6,6 +6,7 @@
 #include <unordered_map>
 
 #include <nx/config.h>
+#include <nx/arena.hpp>
 
 namespace nx {
 
@@ -23,12 +24,21 @@ struct NX_API attribute_base
 class NX_API attribute_map
 {
 public:
-    using map_type = std::unordered_map<std::string, std::string>;
+    using map_type = std::unordered_map<
+        std::string,
+        std::string,
+        std::hash<std::string>,
+        std::equal_to<std::string>,
+        arena_allocator<std::pair<const std::string, std::string>>
+    >;
     using iterator = map_type::iterator;
     using const_iterator = map_type::const_iterator;
 
     attribute_map(char sep = ';');
     attribute_map(const std::string& data, char sep = ';');
+
+    /// Keeps entries in a, which must outlive the map
+    attribute_map(arena& a, char sep = ';');
     attribute_map(const attribute_map& other);
     attribute_map(attribute_map&& other);
     virtual ~attribute_map();
@@ -42,6 +52,11 @@ public:
     const_iterator end() const;
 
     bool has(const std::string& name) const;
+    bool empty() const;
+
+    void reserve(std::size_t count);
+
+    void clear();
 
     std::string& operator[](const std::string& name);
     const std::string& operator[](const std::string& name) const;
@@ -51,6 +66,10 @@ public:
     attribute_map& operator<<(const attribute_map& other);
     attribute_map& operator<<(attribute_map&& other);
 
+    /// Sets a, replacing any value of the same name whatever its case
+    /// (operator<< keeps the first value)
+    attribute_map& replace(const attribute_base& a);
+
     virtual std::ostream& operator()(std::ostream& os) const;
 
 protected:
@@ -2,6 +2,8 @@
 #define __NX_BUFFER_H__
 
 #include <cstring>
+#include <memory>
+#include <utility>
 #include <ostream>
 #include <vector>
 #include <queue>
@@ -17,6 +19,29 @@ using buffer = std::vector<char>;
 using buffers = std::vector<buffer>;
 using buffer_queue = std::queue<buffer>;
 
+/// Allocator leaving value-initialized elements uninitialized
+template <typename T>
+struct default_init_allocator : public std::allocator<T>
+{
+    template <typename U>
+    struct rebind
+    { using other = default_init_allocator<U>; };
+
+    using std::allocator<T>::allocator;
+
+    template <typename U>
+    void construct(U* p)
+    { ::new (static_cast<void*>(p)) U; }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+};
+
+/// Storage whose resize() doesn't fill new bytes (socket input)
+using raw_buffer = std::vector<char, default_init_allocator<char>>;
+using raw_buffers = std::vector<raw_buffer>;
+
 /// Generic output iterator-based streaming support
 ///
 /// @tparam T any type supporting begin() and end()
@@ -0,0 +1,84 @@
+#ifndef __NX_BUFFER_POOL_H__
+#define __NX_BUFFER_POOL_H__
+
+#include <array>
+#include <mutex>
+
+#include <nx/config.h>
+#include <nx/buffer.hpp>
+
+namespace nx {
+
+/// @file
+///
+/// Shared pool of read buffers and adaptive read sizing
+
+/// Process-wide pool of buffer storage, bucketed in power-of-two size classes
+class NX_API buffer_pool
+{
+public:
+    static constexpr std::size_t min_size = 4 * 1024;
+    static constexpr std::size_t max_size = 1024 * 1024;
+    static constexpr std::size_t max_free = 64;
+
+    static buffer_pool& get();
+
+    /// Returns an empty buffer able to hold at least size bytes
+    buffer acquire(std::size_t size);
+
+    /// Takes b storage back into the pool, leaving b empty
+    void release(buffer& b);
+
+    /// Same for raw buffers, pooled apart
+    raw_buffer acquire_raw(std::size_t size);
+    void release(raw_buffer& b);
+
+    /// Frees all pooled storage
+    void trim();
+
+private:
+    static constexpr std::size_t class_count = 9;
+
+    buffer_pool() = default;
+    buffer_pool(const buffer_pool&) = delete;
+    void operator=(const buffer_pool&) = delete;
+
+    template <typename Buffer>
+    Buffer acquire(
+        std::array<std::vector<Buffer>, class_count>& free,
+        std::size_t size
+    );
+
+    template <typename Buffer>
+    void release(
+        std::array<std::vector<Buffer>, class_count>& free,
+        Buffer& b
+    );
+
+    std::mutex m_;
+    std::array<buffers, class_count> free_;
+    std::array<raw_buffers, class_count> free_raw_;
+};
+
+/// Read size that follows observed traffic
+///
+/// Grows when reads fill the whole buffer, shrinks after a streak of
+/// reads using less than a quarter of it.
+class NX_API read_size
+{
+public:
+    static constexpr std::size_t shrink_after = 8;
+
+    std::size_t operator()() const
+    { return size_; }
+
+    void update(std::size_t count);
+
+private:
+    std::size_t size_ = buffer_pool::min_size;
+    std::size_t short_reads_ = 0;
+};
+
+} // namespace nx
+
+#endif // __NX_BUFFER_POOL_H__
@@ -5,6 +5,7 @@
 #include <tuple>
 #include <type_traits>
 
+#include <nx/function.hpp>
 #include <nx/tuple_utils.hpp>
 #include <nx/utils.hpp>
 
@@ -23,14 +24,11 @@ public:
 
     using this_type = callback<Tag, Args...>;
     using tag_type = Tag;
-    using type = std::function<void(Args...)>;
+    using type = unique_function<void(Args...)>;
 
     operator bool() const
     { return (bool) cb_; }
 
-    operator type() const
-    { return cb_; }
-
     bool operator()(Args... args)
     {
         bool called = false;
@@ -46,16 +44,10 @@ public:
     void reset()
     { cb_ = nullptr; }
 
-    this_type& operator=(const type& cb)
-    {
-        cb_ = cb;
-
-        return *this;
-    }
-
-    this_type& operator=(type&& cb)
+    template <typename Callable>
+    this_type& operator=(Callable&& cb)
     {
-        cb_ = std::move(cb);
+        cb_ = std::forward<Callable>(cb);
 
         return *this;
     }
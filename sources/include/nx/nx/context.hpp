@@ -58,6 +58,16 @@ public:
 
     void stop();
 
+    /// Limits output queued on the connection, see socket::write_limits()
+    void write_limits(std::size_t bytes, std::size_t frames, write_policy policy);
+
+    /// Bytes queued on the connection and not written yet
+    std::size_t queued_bytes() const;
+
+    /// Tells if the connection has room for another frame, producers may
+    /// wait for on_drain otherwise
+    bool writable() const;
+
     std::string uid();
     std::string uid() const;
 
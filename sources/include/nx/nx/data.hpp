@@ -24,6 +24,9 @@ class NX_API data
 public:
     std::size_t size() const;
 
+    /// Tells if some data is sent from files
+    bool has_files() const;
+
     void clear();
 
     template <typename Socket>
@@ -59,6 +62,7 @@ public:
 
     data& operator<<(const file& f);
     data& operator<<(const data& other);
+    data& operator<<(data&& other);
 
 private:
     using stream_type = std::ostringstream;
@@ -3,6 +3,8 @@
 
 #include <fcntl.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <string>
 #include <queue>
@@ -73,45 +75,54 @@ void send_file_done(
 template <typename Socket, typename Callable>
 void send_file_write(Socket& s, file_state fs, Callable cb)
 {
-    if (fs.offset == fs.total) {
-        // We're done
-        send_file_done(fs, error_code(), cb, fs.total);
-        return;
-    }
+    // Keep sending while the socket takes data, only go back to the event
+    // loop when its send buffer is full
+    while (fs.offset < fs.total) {
+        // Call platform specific implementation
+        auto result = send_file(
+            s.sock().native(),
+            fs.fd,
+            &fs.offset,
+            fs.total - fs.offset
+        );
 
-    // Call platform specific implementation
-    auto result = send_file(
-        s.sock().native(),
-        fs.fd,
-        &fs.offset,
-        fs.total - fs.offset
-    );
+        if (result == -1) {
+            auto ec = make_error_code();
 
-    if (result == -1) {
-        auto ec = make_error_code();
+            if (ec == asio::error::interrupted) {
+                continue;
+            }
+
+            if (ec != asio::error::would_block) {
+                send_file_done(fs, ec, cb, fs.offset);
+                return;
+            }
 
-        if (ec == asio::error::would_block) {
             asio::async_write(
                 s.sock(),
                 asio::null_buffers(),
-                [&s,fs,cb](const error_code& ec, std::size_t count) {
+                s.wrap([&s,fs,cb](const error_code& ec, std::size_t count) {
+                    if (ec) {
+                        send_file_done(fs, ec, cb, fs.offset);
+                        return;
+                    }
+
                     // Socket is writeable
                     send_file_write(s, fs, cb);
-                }
+                })
             );
-        } else {
-            send_file_done(fs, ec, cb, fs.offset);
+
+            return;
+        }
+
+        if (result == 0) {
+            // File shrunk since it was opened
+            break;
         }
-    } else {
-        asio::async_write(
-            s.sock(),
-            asio::null_buffers(),
-            [&s,fs,cb](const error_code& ec, std::size_t count) {
-                // Socket is writeable
-                send_file_write(s, fs, cb);
-            }
-        );
     }
+
+    // We're done
+    send_file_done(fs, error_code(), cb, fs.offset);
 }
 
 };
@@ -121,20 +132,23 @@ void
 send_file(Socket& s, const file& f, Callable cb)
 {
     auto fs = detail::file_state{ f, -1, 0, 0 };
+    struct stat st;
 
-    if (!cxxu::file_exists(fs.f.path)) {
-        return;
-    }
+    fs.fd = ::open(fs.f.path.c_str(), O_RDONLY | O_CLOEXEC);
 
-    fs.total = cxxu::file_size(fs.f.path);
-    fs.fd = ::open(fs.f.path.c_str(), O_RDONLY);
+    if (fs.fd != -1 && ::fstat(fs.fd, &st) == 0) {
+        fs.total = st.st_size;
+    }
 
     if (fs.fd == -1) {
         auto ec = make_error_code();
 
-        s.postpone() << [fs,cb,ec]() {
-            send_file_done(fs, ec, cb, fs.total);
-        };
+        // Report on the socket event loop, like other completions
+        s.sock().get_io_service().post(
+            s.wrap([fs,cb,ec]() {
+                send_file_done(fs, ec, cb, fs.total);
+            })
+        );
     } else {
         detail::send_file_write(s, fs, cb);
     }
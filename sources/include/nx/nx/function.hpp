@@ -0,0 +1,322 @@
+#ifndef __NX_FUNCTION_H__
+#define __NX_FUNCTION_H__
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace nx {
+
+/// @file
+///
+/// Move-only type-erased callable with inline storage
+
+namespace detail {
+
+template <typename... Ts>
+struct make_void
+{ using type = void; };
+
+template <typename F, typename R, typename Args, typename = void>
+struct is_callable_r : std::false_type {};
+
+template <typename F, typename R, typename... Args>
+struct is_callable_r<
+    F,
+    R,
+    void(Args...),
+    typename make_void<
+        decltype(std::declval<F&>()(std::declval<Args>()...))
+    >::type
+>
+    : std::integral_constant<
+        bool,
+        std::is_void<R>::value
+        ||
+        std::is_convertible<
+            decltype(std::declval<F&>()(std::declval<Args>()...)),
+            R
+        >::value
+    >
+{};
+
+// Discards results for void signatures, like std::function
+template <typename R>
+struct invoker
+{
+    template <typename F, typename... Args>
+    static R call(F& f, Args&&... args)
+    { return f(std::forward<Args>(args)...); }
+};
+
+template <>
+struct invoker<void>
+{
+    template <typename F, typename... Args>
+    static void call(F& f, Args&&... args)
+    { f(std::forward<Args>(args)...); }
+};
+
+// Empty std::function or null pointers make empty unique_functions
+template <typename F>
+bool
+is_null(const F&)
+{ return false; }
+
+template <typename Signature>
+bool
+is_null(const std::function<Signature>& f)
+{ return !f; }
+
+template <typename R, typename... Args>
+bool
+is_null(R (*f)(Args...))
+{ return f == nullptr; }
+
+} // namespace detail
+
+template <typename Signature, std::size_t Size = 48>
+class unique_function;
+
+/// Like std::function, but move-only and keeping callables up to Size
+/// bytes inline, which covers usual captures (this, a shared_ptr, a
+/// couple of references) without a heap allocation
+template <typename R, typename... Args, std::size_t Size>
+class unique_function<R(Args...), Size>
+{
+public:
+    using result_type = R;
+
+    unique_function() = default;
+
+    unique_function(std::nullptr_t)
+    {}
+
+    template <
+        typename F,
+        typename Callable = std::decay_t<F>,
+        typename = std::enable_if_t<
+            !std::is_same<Callable, unique_function>::value
+            &&
+            detail::is_callable_r<Callable, R, void(Args...)>::value
+        >
+    >
+    unique_function(F&& f)
+    { assign<Callable>(std::forward<F>(f)); }
+
+    unique_function(unique_function&& other) noexcept
+    { move_from(other); }
+
+    unique_function(const unique_function&) = delete;
+
+    ~unique_function()
+    { reset(); }
+
+    unique_function& operator=(unique_function&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            move_from(other);
+        }
+
+        return *this;
+    }
+
+    unique_function& operator=(const unique_function&) = delete;
+
+    unique_function& operator=(std::nullptr_t)
+    {
+        reset();
+
+        return *this;
+    }
+
+    template <
+        typename F,
+        typename Callable = std::decay_t<F>,
+        typename = std::enable_if_t<
+            !std::is_same<Callable, unique_function>::value
+            &&
+            detail::is_callable_r<Callable, R, void(Args...)>::value
+        >
+    >
+    unique_function& operator=(F&& f)
+    {
+        reset();
+        assign<Callable>(std::forward<F>(f));
+
+        return *this;
+    }
+
+    explicit operator bool() const
+    { return ops_ != nullptr; }
+
+    R operator()(Args... args) const
+    {
+        if (!ops_) {
+            throw std::bad_function_call();
+        }
+
+        return ops_->invoke(&storage_, std::forward<Args>(args)...);
+    }
+
+private:
+    using storage_type = std::aligned_storage_t<
+        Size,
+        alignof(std::max_align_t)
+    >;
+
+    struct ops
+    {
+        R (*invoke)(void* s, Args&&... args);
+        void (*move)(void* to, void* from);
+        void (*destroy)(void* s);
+    };
+
+    template <typename Callable>
+    struct is_inline
+        : std::integral_constant<
+            bool,
+            sizeof(Callable) <= Size
+            &&
+            alignof(std::max_align_t) % alignof(Callable) == 0
+            &&
+            std::is_nothrow_move_constructible<Callable>::value
+        >
+    {};
+
+    template <typename Callable>
+    struct inline_ops
+    {
+        static Callable& get(void* s)
+        { return *static_cast<Callable*>(s); }
+
+        static R invoke(void* s, Args&&... args)
+        { return detail::invoker<R>::call(get(s), std::forward<Args>(args)...); }
+
+        static void move(void* to, void* from)
+        {
+            ::new (to) Callable(std::move(get(from)));
+            get(from).~Callable();
+        }
+
+        static void destroy(void* s)
+        { get(s).~Callable(); }
+
+        static const ops* table()
+        {
+            static const ops t{ &invoke, &move, &destroy };
+            return &t;
+        }
+    };
+
+    template <typename Callable>
+    struct heap_ops
+    {
+        static Callable*& get(void* s)
+        { return *static_cast<Callable**>(s); }
+
+        static R invoke(void* s, Args&&... args)
+        { return detail::invoker<R>::call(*get(s), std::forward<Args>(args)...); }
+
+        static void move(void* to, void* from)
+        { ::new (to) Callable*(get(from)); }
+
+        static void destroy(void* s)
+        { delete get(s); }
+
+        static const ops* table()
+        {
+            static const ops t{ &invoke, &move, &destroy };
+            return &t;
+        }
+    };
+
+    template <typename Callable, typename F>
+    std::enable_if_t<is_inline<Callable>::value>
+    assign(F&& f)
+    {
+        if (detail::is_null(f)) {
+            return;
+        }
+
+        ::new (&storage_) Callable(std::forward<F>(f));
+        ops_ = inline_ops<Callable>::table();
+    }
+
+    template <typename Callable, typename F>
+    std::enable_if_t<!is_inline<Callable>::value>
+    assign(F&& f)
+    {
+        if (detail::is_null(f)) {
+            return;
+        }
+
+        ::new (&storage_) Callable*(new Callable(std::forward<F>(f)));
+        ops_ = heap_ops<Callable>::table();
+    }
+
+    void move_from(unique_function& other)
+    {
+        if (other.ops_) {
+            other.ops_->move(&storage_, &other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    void reset()
+    {
+        if (ops_) {
+            ops_->destroy(&storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    mutable storage_type storage_;
+    const ops* ops_ = nullptr;
+};
+
+/// Copyable wrapper for handing move-only callables to asio calls that
+/// require copyable handlers, copies take the callable over
+template <typename Callable>
+class posted
+{
+public:
+    explicit posted(Callable&& cb)
+    : cb_(std::move(cb))
+    {}
+
+    posted(const posted& other)
+    : cb_(std::move(other.cb_))
+    {}
+
+    posted(posted&& other) = default;
+
+    void operator()()
+    { cb_(); }
+
+private:
+    mutable Callable cb_;
+};
+
+template <typename Callable>
+posted<std::decay_t<Callable>>
+make_posted(Callable&& cb)
+{ return posted<std::decay_t<Callable>>(std::forward<Callable>(cb)); }
+
+template <typename R, typename... Args, std::size_t Size>
+bool
+operator==(const unique_function<R(Args...), Size>& f, std::nullptr_t)
+{ return !f; }
+
+template <typename R, typename... Args, std::size_t Size>
+bool
+operator!=(const unique_function<R(Args...), Size>& f, std::nullptr_t)
+{ return (bool) f; }
+
+} // namespace nx
+
+#endif // __NX_FUNCTION_H__
@@ -1,12 +1,13 @@
 #ifndef __NX_HANDLERS_H__
 #define __NX_HANDLERS_H__
 
-#include <functional>
 #include <vector>
 
+#include <nx/function.hpp>
+
 namespace nx {
 
-using void_cb = std::function<void()>;
+using void_cb = unique_function<void()>;
 using void_cbs = std::vector<void_cb>;
 
 } // namespace nx
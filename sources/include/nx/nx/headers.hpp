@@ -3,6 +3,10 @@
 
 #include <string>
 
+#include <boost/utility/string_ref.hpp>
+
+#include <nx/picohttpparser.h>
+
 #include <nx/config.h>
 #include <nx/attributes.hpp>
 
@@ -20,6 +24,9 @@ const std::string Upgrade = "Upgrade";
 const std::string upgrade = "upgrade";
 const std::string Connection = "Connection";
 const std::string connection = "connection";
+const std::string Keep_Alive = "keep-alive";
+const std::string Transfer_Encoding = "Transfer-Encoding";
+const std::string transfer_encoding = "transfer-encoding";
 const std::string Sec_WebSocket_Key = "Sec-WebSocket-Key";
 const std::string sec_websocket_key = "sec-websocket-key";
 const std::string Sec_WebSocket_Protocol = "Sec-WebSocket-Protocol";
@@ -42,11 +49,54 @@ struct header : public attribute_base
     using attribute_base::attribute_base;
 };
 
+using string_ref = boost::string_ref;
+
+/// Parsed headers viewing the message head they were parsed from, names
+/// are looked up case-insensitively without copies
+class NX_API header_views
+{
+public:
+    header_views() = default;
+    header_views(const phr_header* h, std::size_t count);
+
+    const phr_header* begin() const
+    { return h_; }
+
+    const phr_header* end() const
+    { return h_ + count_; }
+
+    std::size_t size() const
+    { return count_; }
+
+    bool has(string_ref name) const;
+
+    /// Value of header name, empty when missing
+    string_ref operator[](string_ref name) const;
+
+    const phr_header* find(string_ref name) const;
+
+private:
+    const phr_header* h_ = nullptr;
+    std::size_t count_ = 0;
+};
+
+inline
+string_ref
+name_of(const phr_header& h)
+{ return string_ref(h.name, h.name_len); }
+
+inline
+string_ref
+value_of(const phr_header& h)
+{ return string_ref(h.value, h.value_len); }
+
 const header text_plain = { Content_Type, "text/plain" };
 const header application_json = { Content_Type, "application/json" };
 const header upgrade_websocket = { Upgrade, "websocket" };
 const header connection_upgrade = { Connection, Upgrade };
 const header connection_close = { Connection, "close" };
+const header connection_keep_alive = { Connection, Keep_Alive };
+const header transfer_encoding_chunked = { Transfer_Encoding, "chunked" };
 
 } // namespace nx
 
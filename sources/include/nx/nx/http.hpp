@@ -1,7 +1,15 @@
 #ifndef __NX_HTTP_H__
 #define __NX_HTTP_H__
 
+#include <cstring>
 #include <functional>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <boost/asio/steady_timer.hpp>
 
 #include <nx/config.h>
 #include <nx/tcp.hpp>
@@ -21,6 +29,57 @@ using reply_cb = std::function<
     void(reply& rep, buffer& data)
 >;
 
+/// Receives parts of a streamed request body as they arrive
+using body_cb = std::function<
+    void(request& req, buffer& chunk, reply& rep)
+>;
+
+/// Handlers of a request, picked once its headers are in
+struct request_handlers
+{
+    /// Gets the whole request, the server request callback is used when
+    /// empty
+    request_cb on_request;
+
+    /// Gets the body as it arrives, or empty to get the whole body with
+    /// the request
+    body_cb on_body;
+};
+
+/// Called once request headers are in, picks the handlers of the request
+using body_route_cb = std::function<
+    request_handlers(request& req)
+>;
+
+/// Default HTTP socket options, requests and replies are small
+/// latency-bound writes
+inline
+socket_options
+http_socket_options()
+{
+    socket_options o;
+
+    o.nodelay = true;
+
+    return o;
+}
+
+/// Persistent connection settings of HTTP servers
+struct http_keep_alive
+{
+    /// Requests served on a connection before it is closed (1 disables
+    /// keep-alive, 0 acts the same)
+    std::size_t max_requests = 1000;
+
+    /// Time a connection may wait for the head of its next request,
+    /// including the first one
+    std::chrono::milliseconds idle_timeout = std::chrono::seconds(15);
+
+    /// Pipelined requests dispatched ahead of their replies, further
+    /// input waits in the receive buffer
+    std::size_t max_pipelined = 16;
+};
+
 struct http_async_tag {};
 struct http_sync_tag {};
 
@@ -57,61 +116,24 @@ public:
     http& operator=(const http& other) = delete;
     http& operator=(http&& other) = default;
 
+    /// Parses and dispatches every complete request in the receive
+    /// buffer, replies are written in request order
     void process_request()
-    {
-        call_or_fail(
-            [&]() {
-                if (!request_parsed() || this->rbuf().size() < this->req_.content_length()) {
-                    // Wait until request is complete
-                    return;
-                }
-
-                if (this->req_.is_form()) {
-                    // Decode additional variables from body
-                    // TODO: implement iterator based function to avoid copy
-                    std::string body;
-                    this->rbuf() >> body;
-                    this->req_ << attributes(body, '&');
-                }
-
-                auto self = this->ptr();
-                if (this->req_.is_upgrade()) {
-                    ws_type::server_handshake(this->req_, this->rep_);
-
-                    this->rep_ | [this,self]() mutable {
-                        *this << this->rep_;
-
-                        process_upgrade();
-                    };
-
-                    // All data arrived, call upper handler
-                    this->request_cb_(this->req_, this->rbuf(), this->rep_);
-                } else {
-                    // Register callback to be called when reply is ready to send
-                    // (will be called last by rep.done())
-                    this->rep_ << connection_close;
-
-                    this->rep_ | [this,self]() mutable {
-                        *this << this->rep_;
-                        this->close_after_write();
-                        self.reset();
-                    };
+    { pump(); }
 
-                    // All data arrived, call upper handler
-                    this->request_cb_(this->req_, this->rbuf(), this->rep_);
-                }
-            }
-        );
+    /// Waits for requests on a new connection, it is closed if none comes
+    /// within the idle timeout
+    void wait_requests()
+    {
+        auto self = this->ptr();
 
-        if (!this->rep_.postponed()) {
-            this->rep_.done();
-        }
+        this->post([this,self]() { pump(); });
     }
 
     bool process_reply()
     {
         try {
-            if (!reply_parsed() || this->rbuf().size() < this->rep_.content_length()) {
+            if (!reply_parsed() || !reply_body_complete()) {
                 // Wait until response is complete
                 return false;
             }
@@ -121,8 +143,19 @@ public:
             this->rep_ << BadResponse(e);
         }
 
+        if (!reply_chunked_) {
+            // Replies without length run until the connection closes
+            auto size = this->rbuf().size();
+
+            if (this->rep_.has(nx::content_length)) {
+                size = std::min(size, this->rep_.content_length());
+            }
+
+            take_body(size, body_);
+        }
+
         // All data arrived, call upper handler
-        this->reply_cb_(this->rep_, this->rbuf());
+        this->reply_cb_(this->rep_, body_);
         this->close();
         return true;
     }
@@ -149,68 +182,639 @@ public:
         return *this;
     }
 
+    http& operator<<(body_route_cb cb)
+    {
+        this->body_route_cb_ = std::move(cb);
+
+        return *this;
+    }
+
+    const body_route_cb& body_route() const
+    { return body_route_cb_; }
+
+    void keep_alive(const http_keep_alive& k)
+    { keep_alive_ = k; }
+
+    const http_keep_alive& keep_alive() const
+    { return keep_alive_; }
+
     template<
         typename SocketType,
         typename ...Args
     >
     SocketType& upgrade_connection(Args&& ...args)
     {
-        auto upg_ct = new_object<SocketType>(this->sock(), std::forward<Args>(args)...);
+        auto upg_ct = new_pooled_object<SocketType>(this->sock(), std::forward<Args>(args)...);
         auto& upg = *upg_ct;
 
         return upg;
     }
 
 private:
-    bool request_parsed()
+    // Request and reply of a pipelined exchange
+    struct exchange
     {
-        if (!this->parsed_) {
-           this-> parsed_ = this->req_.parse(this->rbuf());
+        request req;
+        reply rep;
+        buffer body;
+        std::vector<nx::data> held;
+        request_cb on_request;
+        body_cb on_body;
+        std::size_t body_left = 0;
+        phr_chunked_decoder decoder;
+        bool parsed = false;
+        bool routed = false;
+        bool streamed = false;
+        bool chunked = false;
+        bool paused = false;
+        bool failed = false;
+        bool keep = false;
+        bool ready = false;
+    };
+
+    using exchange_ptr = std::unique_ptr<exchange>;
+
+    void pump()
+    {
+        if (pumping_) {
+            // Replies done inline, the outer loop goes on
+            return;
         }
 
-        return this->parsed_;
+        pumping_ = true;
+
+        while (true) {
+            if (receiving_) {
+                if (!feed_body(*receiving_)) {
+                    // Wait for more input, or for the handler to resume
+                    break;
+                }
+
+                continue;
+            }
+
+            if (last_ || pipeline_.size() >= keep_alive_.max_pipelined) {
+                break;
+            }
+
+            if (!incoming_) {
+                incoming_ = take_exchange();
+            }
+
+            if (!take_request(*incoming_)) {
+                // Wait until request is complete
+                break;
+            }
+
+            auto& e = *incoming_;
+
+            pipeline_.push_back(std::move(incoming_));
+            begin_request(e);
+
+            if (e.streamed) {
+                receiving_ = &e;
+            } else {
+                run_request(e);
+            }
+        }
+
+        pumping_ = false;
+
+        // Idle until a request head is complete: partial heads don't
+        // postpone the timeout
+        bool busy =
+            last_
+            ||
+            !pipeline_.empty()
+            ||
+            (incoming_ && incoming_->parsed)
+            ;
+
+        if (busy) {
+            stop_idle();
+        } else if (!idle_) {
+            wait_idle();
+        }
+    }
+
+    // Moves a whole request out of the receive buffer, parse errors are
+    // replied and end the connection
+    bool take_request(exchange& e)
+    {
+        try {
+            if (!request_parsed(e)) {
+                return false;
+            }
+
+            if (!e.routed) {
+                e.routed = true;
+                route_body(e);
+            }
+
+            if (e.streamed) {
+                // Body is fed as it arrives
+                this->expect_input(0);
+                return true;
+            }
+
+            if (this->rbuf().size() < e.req.content_length()) {
+                return false;
+            }
+
+            // Requests without length have no body, anything after
+            // belongs to the next pipelined request
+            take_body(e.req.content_length(), e.body);
+
+            if (e.req.is_form()) {
+                // Decode additional variables from body
+                std::string body(e.body.begin(), e.body.end());
+                e.body.clear();
+                e.req << attributes(body, '&');
+            }
+
+            return true;
+        } catch (const http_status& s) {
+            e.rep << s;
+        } catch (const std::exception& ex) {
+            std::cout << "BadRequest by " << ex.what() << std::endl;
+            e.rep << BadRequest(ex);
+        }
+
+        e.failed = true;
+
+        return true;
+    }
+
+    // Picks where the body goes, chunked bodies are always decoded as
+    // they arrive
+    void route_body(exchange& e)
+    {
+        if (body_route_cb_) {
+            auto h = body_route_cb_(e.req);
+
+            e.on_request = std::move(h.on_request);
+            e.on_body = std::move(h.on_body);
+        }
+
+        e.chunked = e.req.has(transfer_encoding_chunked);
+        e.streamed = e.on_body || e.chunked;
+        e.body_left = e.req.content_length();
+
+        if (e.chunked) {
+            e.decoder = phr_chunked_decoder();
+            e.decoder.consume_trailer = 1;
+        }
+    }
+
+    // Hands available body input to the exchange, tells if the body ended
+    bool feed_body(exchange& e)
+    {
+        if (e.paused) {
+            return false;
+        }
+
+        auto& b = this->rbuf();
+        buffer chunk;
+        bool end = false;
+        bool failed = false;
+
+        try {
+            if (e.chunked) {
+                end = decode_chunk(e, chunk);
+            } else {
+                auto size = std::min(b.size(), e.body_left);
+
+                chunk.assign(b.begin(), b.begin() + size);
+                b.consume(size);
+                e.body_left -= size;
+                end = e.body_left == 0;
+            }
+
+            if (!chunk.empty()) {
+                if (e.on_body) {
+                    e.on_body(e.req, chunk, e.rep);
+                } else {
+                    e.body.insert(e.body.end(), chunk.begin(), chunk.end());
+                }
+            }
+        } catch (const http_status& s) {
+            e.rep << s;
+            failed = true;
+        } catch (const std::exception& ex) {
+            e.rep << BadRequest(ex);
+            failed = true;
+        }
+
+        if (failed) {
+            // Input can't be trusted past a failed body
+            e.failed = true;
+            e.keep = false;
+            e.rep << connection_close;
+            last_ = true;
+            end = true;
+        }
+
+        // Input was consumed, reads paused on a full buffer may go on
+        this->resume_read();
+
+        if (!end) {
+            return false;
+        }
+
+        receiving_ = nullptr;
+        run_request(e);
+
+        return true;
+    }
+
+    // Decodes chunked input in place, tells if the last chunk arrived
+    bool decode_chunk(exchange& e, buffer& chunk)
+    {
+        auto& b = this->rbuf();
+        auto size = b.size();
+        auto decoded = size;
+        auto ret = phr_decode_chunked(&e.decoder, b.data(), &decoded);
+
+        if (ret == -1) {
+            throw BadRequest;
+        }
+
+        chunk.assign(b.begin(), b.begin() + decoded);
+
+        if (ret == -2) {
+            b.consume(size);
+            return false;
+        }
+
+        // Keep what follows the body (next pipelined request) in front
+        std::memmove(b.data() + size - ret, b.data() + decoded, ret);
+        b.consume(size - ret);
+
+        return true;
+    }
+
+    void begin_request(exchange& e)
+    {
+        // Hooks live in the exchange, owned by the connection: they don't
+        // keep it alive, replies end with their connection
+        std::weak_ptr<object_base> w = this->ptr();
+        bool upgrade = !e.failed && e.req.is_upgrade();
+
+        e.keep = !e.failed && !upgrade && keep_alive_next(e.req);
+        last_ = !e.keep;
+        requests_++;
+
+        if (!e.keep && !upgrade) {
+            e.rep << connection_close;
+        } else if (e.keep && e.req.minor_version() == 0) {
+            e.rep << connection_keep_alive;
+        }
+
+        // Register callback to be called when reply is ready to send
+        // (will be called last by rep.done()), postponed replies may be
+        // done from any thread
+        e.rep | [this,w,&e]() mutable {
+            if (auto self = w.lock()) {
+                this->dispatch([this,self,&e]() {
+                    e.ready = true;
+                    flush_replies();
+                });
+            }
+        };
+
+        // Streamed parts go out as they come once earlier replies are
+        // written, HTTP/1.0 clients get the body until the connection ends
+        e.rep.on_stream(
+            [this,w,&e](nx::data&& d) mutable {
+                if (auto self = w.lock()) {
+                    this->dispatch([this,self,&e,d = std::move(d)]() mutable {
+                        stream_reply(e, std::move(d));
+                    });
+                }
+            },
+            e.req.minor_version() >= 1
+        );
+
+        if (e.streamed) {
+            e.rep.on_body_flow(
+                [this,w,&e](bool paused) mutable {
+                    if (auto self = w.lock()) {
+                        this->dispatch([this,self,&e,paused]() {
+                            e.paused = paused;
+
+                            if (!paused) {
+                                pump();
+                            }
+                        });
+                    }
+                }
+            );
+        }
+    }
+
+    void run_request(exchange& e)
+    {
+        if (e.ready) {
+            // Replied before the body ended
+            flush_replies();
+            return;
+        }
+
+        bool upgrade = !e.failed && e.req.is_upgrade();
+
+        if (!e.failed) {
+            call_or_fail(
+                e.rep,
+                [&]() {
+                    if (upgrade) {
+                        ws_type::server_handshake(e.req, e.rep);
+                    }
+
+                    // All data arrived, call upper handler
+                    if (e.on_request) {
+                        e.on_request(e.req, e.body, e.rep);
+                    } else {
+                        this->request_cb_(e.req, e.body, e.rep);
+                    }
+                }
+            );
+        }
+
+        if (!e.rep.postponed()) {
+            e.rep.done();
+        }
+    }
+
+    // Writes ready replies in request order, in a single gathered write
+    void flush_replies()
+    {
+        this->batch([&]() {
+            while (!pipeline_.empty()) {
+                auto& head = *pipeline_.front();
+
+                send_held(head);
+
+                if (!head.ready || &head == receiving_) {
+                    // Replies made early wait for the end of their body
+                    break;
+                }
+
+                auto e = std::move(pipeline_.front());
+                pipeline_.pop_front();
+
+                if (!e->rep.streaming()) {
+                    *this << e->rep;
+                }
+
+                // Handlers may have asked to close since the request began
+                bool keep =
+                    e->keep
+                    &&
+                    !e->rep.closes_connection()
+                    &&
+                    (!e->rep.streaming() || e->rep.chunked())
+                    ;
+
+                if (keep) {
+                    // Recycled by take_exchange()
+                } else if (e->rep == SwitchingProtocols) {
+                    process_upgrade(e->rep.websocket_callback());
+                } else {
+                    last_ = true;
+                    this->close_after_write();
+                    spare_.push_back(std::move(e));
+
+                    // Requests after the last reply are dropped
+                    drop_pipeline();
+                    break;
+                }
+
+                spare_.push_back(std::move(e));
+            }
+        });
+
+        if (!last_) {
+            pump();
+        }
+    }
+
+    void drop_pipeline()
+    {
+        receiving_ = nullptr;
+
+        // Kept alive for callbacks of replies still in progress
+        while (!pipeline_.empty()) {
+            spare_.push_back(std::move(pipeline_.front()));
+            pipeline_.pop_front();
+        }
+    }
+
+    void stream_reply(exchange& e, nx::data&& d)
+    {
+        if (!pipeline_.empty() && pipeline_.front().get() == &e) {
+            *this << d;
+        } else {
+            e.held.emplace_back(std::move(d));
+        }
+    }
+
+    void send_held(exchange& e)
+    {
+        for (auto& d : e.held) {
+            *this << d;
+        }
+
+        e.held.clear();
+    }
+
+    exchange_ptr take_exchange()
+    {
+        if (spare_.empty()) {
+            return std::make_unique<exchange>();
+        }
+
+        auto e = std::move(spare_.back());
+        spare_.pop_back();
+
+        // Cleared here rather than when written, the reply may still be
+        // unwinding from done()
+        e->req.clear();
+        e->rep.clear();
+        e->body.clear();
+        e->held.clear();
+        e->on_request = nullptr;
+        e->on_body = nullptr;
+        e->body_left = 0;
+        e->parsed = false;
+        e->routed = false;
+        e->streamed = false;
+        e->chunked = false;
+        e->paused = false;
+        e->failed = false;
+        e->keep = false;
+        e->ready = false;
+
+        return e;
+    }
+
+    bool request_parsed(exchange& e)
+    {
+        if (!e.parsed) {
+           e.parsed = e.req.parse(this->rbuf());
+
+           if (e.parsed) {
+               // Keep reading until the whole body is there
+               this->expect_input(e.req.content_length());
+           }
+        }
+
+        return e.parsed;
     }
 
     bool reply_parsed()
     {
         if (!this->parsed_) {
            this-> parsed_ = this->rep_.parse(this->rbuf());
+
+           if (this->parsed_) {
+               // Keep reading until the whole body is there
+               this->expect_input(this->rep_.content_length());
+
+               reply_chunked_ = this->rep_.has(transfer_encoding_chunked);
+               reply_decoder_ = phr_chunked_decoder();
+               reply_decoder_.consume_trailer = 1;
+           }
         }
 
         return this->parsed_;
     }
 
-    void call_or_fail(void_cb cb)
+    // Chunked bodies are decoded into body_ as they arrive
+    bool reply_body_complete()
+    {
+        auto& b = this->rbuf();
+
+        if (!reply_chunked_) {
+            return b.size() >= this->rep_.content_length();
+        }
+
+        auto size = b.size();
+        auto decoded = size;
+        auto ret = phr_decode_chunked(&reply_decoder_, b.data(), &decoded);
+
+        if (ret == -1) {
+            throw BadResponse;
+        }
+
+        body_.insert(body_.end(), b.begin(), b.begin() + decoded);
+        b.consume(size);
+
+        return ret != -2;
+    }
+
+    // Moves message body out of the receive buffer
+    void take_body(std::size_t size, buffer& body)
+    {
+        auto& b = this->rbuf();
+
+        body.assign(b.begin(), b.begin() + size);
+        b.consume(size);
+        this->expect_input(0);
+    }
+
+    bool keep_alive_next(const request& req) const
+    {
+        return
+            req.keep_alive()
+            &&
+            requests_ + 1 < keep_alive_.max_requests
+            ;
+    }
+
+    void wait_idle()
+    {
+        std::weak_ptr<object_base> w = this->ptr();
+
+        idle_ = true;
+        idle_timer_.expires_from_now(keep_alive_.idle_timeout);
+        idle_timer_.async_wait(
+            [w](const error_code& ec) {
+                if (ec) {
+                    return;
+                }
+
+                if (auto self = w.lock()) {
+                    auto& h = *std::static_pointer_cast<http>(self);
+
+                    // Expired before being stopped or waited again
+                    if (
+                        h.idle_
+                        &&
+                        h.idle_timer_.expires_at()
+                        <= asio::steady_timer::clock_type::now()
+                    ) {
+                        h.close();
+                    }
+                }
+            }
+        );
+    }
+
+    void stop_idle()
+    {
+        if (idle_) {
+            idle_ = false;
+            idle_timer_.cancel();
+        }
+    }
+
+    void call_or_fail(reply& rep, void_cb cb)
     {
        try {
             cb();
         } catch (const http_status& s) {
-            this->rep_ << s;
+            rep << s;
         } catch (const std::exception& e) {
             std::cout << "BadRequest by " << e.what() << std::endl;
-            this->rep_ << BadRequest(e);
+            rep << BadRequest(e);
         }
     }
 
-    void process_upgrade()
+    void process_upgrade(ws_connection callbacks)
     {
         auto self = this->ptr();
-        async() << [this,self]() {
+        auto& io = this->io_service();
+
+        this->post([this,self,&io,callbacks]() {
             this->cancel();
 
             auto& w = this->upgrade_connection<ws_type>();
-            w.set_callbacks(rep_.websocket_callback());
+            w.set_callbacks(callbacks);
 
-            this->dispose();
+            this->dispose(io);
             w.start();
-        };
+        });
     }
 
     bool parsed_ = false;
+    bool reply_chunked_ = false;
+    phr_chunked_decoder reply_decoder_;
+    bool pumping_ = false;
+    bool last_ = false;
+    bool idle_ = false;
+    std::size_t requests_ = 0;
+    exchange_ptr incoming_;
+    exchange* receiving_ = nullptr;
+    std::deque<exchange_ptr> pipeline_;
+    std::vector<exchange_ptr> spare_;
+    http_keep_alive keep_alive_;
+    asio::steady_timer idle_timer_{ this->io_service() };
     request req_;
     reply rep_;
+    buffer body_;
     request_cb request_cb_;
     reply_cb reply_cb_;
+    body_route_cb body_route_cb_;
 };
 
 using http_tcp = http<tcp_base>;
@@ -224,8 +828,10 @@ serve(Http& h, const typename Http::endpoint_type& ep, OnRequest&& cb)
         serve(
             h,
             ep,
-            [cb = std::move(cb)](Http& c) {
-                c << std::move(cb);
+            [&h, cb = std::move(cb)](Http& c) {
+                c << cb << h.body_route();
+                c.keep_alive(h.keep_alive());
+                c.wait_requests();
             },
             [](Http& c) {
                 c.process_request();
@@ -236,11 +842,18 @@ serve(Http& h, const typename Http::endpoint_type& ep, OnRequest&& cb)
 
 template <typename Http, typename OnReply>
 Http&
-async_connect(const typename Http::endpoint_type& ep, request&& req, OnReply&& cb)
+async_connect(
+    const typename Http::endpoint_type& ep,
+    request&& req,
+    OnReply&& cb,
+    const socket_options& o = http_socket_options()
+)
 {
-    auto p = new_object<Http>(std::move(req), std::move(cb));
+    auto p = new_pooled_object<Http>(std::move(req), std::move(cb));
     auto& h = *p;
 
+    h.options(o);
+
     h[tags::on_read] = [](Http& t) {
         t.process_reply();
     };
@@ -256,12 +869,19 @@ async_connect(const typename Http::endpoint_type& ep, request&& req, OnReply&& c
 
 template <typename Http, typename OnReply>
 Http&
-sync_connect(const typename Http::endpoint_type& ep, request&& req, OnReply&& cb, int32_t timeout_s)
+sync_connect(
+    const typename Http::endpoint_type& ep,
+    request&& req,
+    OnReply&& cb,
+    int32_t timeout_s,
+    const socket_options& o = http_socket_options()
+)
 {
     auto t = std::make_shared<task>();
     auto p = new_object<Http>(std::move(req), std::move(cb), t->get_io_service());
 
     auto& h = *p;
+    h.options(o);
     cond_var cv;
 
     h[tags::on_read] = [&cv](Http& t) {
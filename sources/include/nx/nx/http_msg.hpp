@@ -11,6 +11,8 @@
 
 #include <nx/config.h>
 #include <nx/buffer.hpp>
+#include <nx/buffer_pool.hpp>
+#include <nx/recv_buffer.hpp>
 #include <nx/headers.hpp>
 #include <nx/json.hpp>
 #include <nx/file.hpp>
@@ -30,20 +32,39 @@ public:
     http_msg_base& operator=(http_msg_base&& other);
 
     void pre_parse();
-    void post_parse();
 
-    virtual bool parse(buffer& b) = 0;
+    /// Keeps parsed headers as views into a copy of the message head
+    void post_parse(const char* head, std::size_t size);
+
+    /// Resets the message for reuse, releasing its arena
+    virtual void clear();
+
+    bool parse(buffer& b);
+    bool parse(recv_buffer& b);
 
     std::size_t content_length() const;
 
-    virtual std::string header_data() const = 0;
+    /// Appends the start line and headers to b
+    virtual void write_head(buffer& b) const = 0;
+
+    std::string header_data() const;
     const nx::data& data() const;
 
+    /// Header value, parsed headers are converted to owning strings on
+    /// first access
     std::string& h(const std::string& name);
     const std::string& h(const std::string& name) const;
+
+    /// Header value without copies, valid until the message is cleared
+    string_ref hv(string_ref name) const;
+
     bool has(const header& h) const;
     bool has(const std::string& name) const;
 
+    /// Headers set on the message and parsed ones, as owning strings
+    headers all_headers() const;
+
+    /// Sets a header, replacing any other of the same name
     http_msg_base& operator<<(const header& h);
     http_msg_base& operator<<(const headers& h);
     http_msg_base& operator<<(const json& js);
@@ -61,16 +82,30 @@ public:
     bool is_form() const;
 
 protected:
-    using raw_headers_ptr = std::unique_ptr<phr_header[]>;
+    /// Parses message head in data, returns consumed byte count
+    /// (0 when incomplete)
+    virtual std::size_t parse(const char* data, std::size_t size) = 0;
+
     static const std::size_t max_headers = 128;
 
-    raw_headers_ptr raw_headers_ptr_;
-    headers headers_;
+    // Copies a parsed header into headers_ when first asked for
+    void materialize(const std::string& name) const;
+
+    // Appends headers set on the message, then parsed ones
+    void write_headers(buffer& b) const;
+
+    static void write_size(buffer& b, std::size_t n);
+
+    // Parsing allocations, freed with the message
+    arena arena_;
+    phr_header* raw_headers_ = nullptr;
+    header_views parsed_;
+    mutable headers headers_{ arena_ };
     std::size_t content_length_;
     nx::data data_;
     std::string empty_;
 
-    int minor_version_;
+    int minor_version_ = 1;
     std::size_t num_headers_;
     std::size_t prev_buf_len_ = 0;
 };
@@ -99,10 +134,24 @@ template <
 Socket&
 operator<<(Socket& s, const http_msg_base& m)
 {
-    s
-        << m.header_data()
-        << m.data()
-        ;
+    auto send = [&]() {
+        auto head = buffer_pool::get().acquire(buffer_pool::min_size);
+
+        m.write_head(head);
+
+        s
+            << std::move(head)
+            << m.data()
+            ;
+    };
+
+    if (m.data().has_files()) {
+        // Headers and file content leave in separate writes, hold
+        // partial segments until the whole message is queued
+        s.corked(send);
+    } else {
+        s.batch(send);
+    }
 
     return s;
 }
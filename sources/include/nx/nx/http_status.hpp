@@ -2,6 +2,7 @@
 #define __NX_HTTP_CODE_H__
 
 #include <stdint.h>
+#include <string>
 
 #include <nx/config.h>
 
@@ -65,6 +66,10 @@ const http_status MethodNotAllowed = { 405, "Method Not Allowed" };
 const http_status Locked = { 423, "Locked" };
 const http_status InternalServerError = { 500, "Internal server error" };
 
+/// "HTTP/1.1 <code> <status>\r\n" rendered once for the statuses above,
+/// empty for others
+NX_API const std::string& status_line(const http_status& s);
+
 } // namespace nx
 
 #endif // __NX_HTTP_CODE_H__
@@ -32,6 +32,9 @@ public:
         return *this;
     }
 
+    /// Sets socket options of the connection
+    http_request& operator<<(const socket_options& o);
+
     http_request& operator=(reply_cb cb);
 
 private:
@@ -41,6 +44,7 @@ private:
     request req_;
     endpoint ep_;
     reply_cb reply_cb_;
+    socket_options options_;
 };
 
 class NX_API httpc
@@ -2,11 +2,18 @@
 #define __NX_HTTPD_H__
 
 #include <string>
+#include <memory>
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
 
 #include <nx/config.h>
 #include <nx/http.hpp>
 #include <nx/methods.hpp>
 #include <nx/route.hpp>
+#include <nx/router.hpp>
 #include <nx/json_collection.hpp>
 
 namespace nx {
@@ -14,6 +21,10 @@ namespace nx {
 class NX_API httpd
 {
 public:
+    httpd();
+
+    /// Adds a route, served once its handler is set (routes may be added
+    /// while serving)
     route& operator()(const method& m);
     route& operator()(const ws_tag& m);
 
@@ -24,12 +35,35 @@ public:
 
     httpd& operator<<(json_collection_base& c);
 
+    /// Sets socket options of the listeners, inherited by connections
+    httpd& operator<<(const socket_options& o);
+
+    /// Sets persistent connection settings
+    httpd& operator<<(const http_keep_alive& k);
+
 private:
     void operator()(request& req, buffer& data, reply& rep);
 
+    // Finds the route of a request once, its handlers are kept with the
+    // request until it is done
+    request_handlers body_route(request& req);
+
+    route& add_route(const method& m, route_cb cb = route_cb());
+    std::vector<const route*>& method_routes(const method& m);
+
+    // Compiles routes added since last time
+    std::shared_ptr<const router> current_router();
+
     http_tcp s_;
     http_local local_s_;
-    routes_map routes_map_;
+    // All routes, complete ones are listed by method: standard methods by
+    // verb, extension ones by name
+    routes all_routes_;
+    std::array<std::vector<const route*>, verb_count> routes_;
+    std::unordered_map<std::string, std::vector<const route*>> other_routes_;
+    std::shared_ptr<const router> router_;
+    std::atomic_bool dirty_{ true };
+    std::mutex router_mutex_;
 };
 
 } // namespace nx
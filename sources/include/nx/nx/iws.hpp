@@ -8,6 +8,7 @@
 
 #include <nx/config.h>
 #include <nx/buffer.hpp>
+#include <nx/write_queue.hpp>
 
 namespace nx {
 
@@ -62,6 +63,14 @@ public:
     virtual void push_in_socket(buffer&& b) = 0;
     virtual void push_in_socket(std::string&& s) = 0;
     virtual void push_in_socket(std::string& s) = 0;
+
+    virtual void write_limits(
+        std::size_t bytes,
+        std::size_t frames,
+        write_policy policy
+    ) = 0;
+    virtual std::size_t queued_bytes() const = 0;
+    virtual bool writable() const = 0;
 };
 
 } // namespace nx
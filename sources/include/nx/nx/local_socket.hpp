@@ -2,6 +2,7 @@
 #define __NX_LOCAL_SOCKET_H__
 
 #include <nx/socket.hpp>
+#include <nx/socket_options.hpp>
 #include <nx/socket_template_functions.hpp>
 
 namespace nx{
@@ -24,6 +25,9 @@ public:
     using acceptor_type = asio::local::stream_protocol::acceptor;
     using endpoint_type = asio::local::stream_protocol::endpoint;
 
+    /// Local sockets can't share a path between acceptors
+    static constexpr bool per_loop_acceptors = false;
+
     using base_type::base_type;
 
     local_socket_base() = default;
@@ -61,29 +65,84 @@ public:
     }
 
     acceptor_type& make_acceptor()
+    { return make_acceptor(base_type::io_service()); }
+
+    /// Replaces acceptors with a single one running on io
+    acceptor_type& make_acceptor(asio::io_service& io)
+    {
+        acceptors_.clear();
+
+        return add_acceptor(io);
+    }
+
+    acceptor_type& add_acceptor(asio::io_service& io)
     {
-        acceptor_ptr_ = std::make_unique<acceptor_type>(
-            base_type::io_service()
-        );
+        acceptors_.emplace_back(std::make_unique<acceptor_type>(io));
 
-        return *acceptor_ptr_;
+        return *acceptors_.back();
     }
 
-    acceptor_type& acceptor()
-    { return *acceptor_ptr_; }
+    std::size_t acceptor_count() const
+    { return acceptors_.size(); }
+
+    acceptor_type& acceptor(std::size_t i = 0)
+    { return *acceptors_[i]; }
 
-    const acceptor_type& acceptor() const
-    { return *acceptor_ptr_; }
+    const acceptor_type& acceptor(std::size_t i = 0) const
+    { return *acceptors_[i]; }
 
     void reuse_addr(acceptor_type& , const endpoint_type& from)
     {
         unlink(from.path().c_str());
     }
 
+    void reuse_port(acceptor_type&)
+    {}
+
+    /// Sets options, only buffer sizes apply to local sockets
+    void options(const socket_options& o)
+    {
+        options_ = o;
+        apply_options();
+    }
+
+    const socket_options& options() const
+    { return options_; }
+
+    void inherit_options(const Derived& listener)
+    { options(listener.options()); }
+
+    void apply_options()
+    {
+        if (!base_type::sock().is_open()) {
+            return;
+        }
+
+        error_code ec;
+
+        if (options_.send_buffer_size) {
+            base_type::sock().set_option(
+                asio::socket_base::send_buffer_size(*options_.send_buffer_size),
+                ec
+            );
+        }
+
+        if (options_.receive_buffer_size) {
+            base_type::sock().set_option(
+                asio::socket_base::receive_buffer_size(*options_.receive_buffer_size),
+                ec
+            );
+        }
+    }
+
+    void cork(bool)
+    {}
+
 private:
     using acceptor_ptr = std::unique_ptr<acceptor_type>;
 
-    acceptor_ptr acceptor_ptr_;
+    std::vector<acceptor_ptr> acceptors_;
+    socket_options options_;
 };
 
 class local_socket : public local_socket_base<local_socket>
@@ -0,0 +1,35 @@
+#ifndef __NX_LOOP_H__
+#define __NX_LOOP_H__
+
+#include <boost/asio.hpp>
+
+#include <nx/config.h>
+
+namespace nx {
+
+namespace asio = boost::asio;
+
+/// Runs io until stopped, flagging the calling thread as its event loop
+NX_API
+void
+run_loop(asio::io_service& io);
+
+/// Runs io ready handlers, flagging the calling thread as its event loop
+NX_API
+std::size_t
+poll_loop(asio::io_service& io, boost::system::error_code& ec);
+
+/// Tells if the calling thread is the event loop running io
+NX_API
+bool
+in_loop(const asio::io_service& io);
+
+/// Returns the io_service run by the calling thread, nullptr outside of
+/// an event loop
+NX_API
+asio::io_service*
+current_loop();
+
+} // namespace nx
+
+#endif // __NX_LOOP_H__
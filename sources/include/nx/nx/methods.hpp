@@ -2,30 +2,61 @@
 #define __NX_METHODS_H__
 
 #include <string>
+#include <cstdint>
 
+#include <nx/config.h>
 #include <nx/endpoint.hpp>
 
 namespace nx {
 
+/// Standard HTTP methods, other for extension methods (known by name only)
+enum class verb : std::uint8_t
+{
+    get,
+    head,
+    post,
+    put,
+    delete_,
+    connect,
+    options,
+    trace,
+    patch,
+    other
+};
+
+/// Number of standard methods
+const std::size_t verb_count = static_cast<std::size_t>(verb::other);
+
+NX_API verb verb_of(const char* name, std::size_t len);
+NX_API verb verb_of(const std::string& name);
+
+/// Name of a standard method
+NX_API const char* verb_name(verb v);
+
 /**
  HTTP Method
  */
 const std::string get_method = "GET";
+const std::string head_method = "HEAD";
 const std::string put_method = "PUT";
 const std::string post_method = "POST";
 const std::string delete_method = "DELETE";
 const std::string options_method = "OPTIONS";
+const std::string patch_method = "PATCH";
 
 struct method
 {
     const std::string& str;
+    verb id = verb::other;
 };
 
-const method GET = { get_method };
-const method PUT = { put_method };
-const method POST = { post_method };
-const method DELETE = { delete_method };
-const method OPTIONS = { options_method };
+const method GET = { get_method, verb::get };
+const method HEAD = { head_method, verb::head };
+const method PUT = { put_method, verb::put };
+const method POST = { post_method, verb::post };
+const method DELETE = { delete_method, verb::delete_ };
+const method OPTIONS = { options_method, verb::options };
+const method PATCH = { patch_method, verb::patch };
 
 } // namespace nx
 
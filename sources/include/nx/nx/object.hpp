@@ -14,9 +14,11 @@ struct postponer
     {
         auto ptr = o.ptr();
 
-        async() << [ptr, cb = std::move(cb)]() {
-            cb();
-        };
+        // Posted as is, wrapping it in another void_cb would not fit
+        // inline storage
+        service::get().io_service().post(
+            make_posted([ptr, cb = std::move(cb)]() { cb(); })
+        );
 
         return *this;
     }
@@ -30,9 +32,7 @@ struct external_postponer
     {
         auto ptr = o.ptr();
 
-        io.post([ptr,cb = std::move(cb)](){
-            cb();
-        });
+        io.post(make_posted([ptr,cb = std::move(cb)]() { cb(); }));
 
         return *this;
     }
@@ -69,6 +69,17 @@ public:
         };
     }
 
+    /// Removes the object once io, the loop it lives on, is done with
+    /// handlers already queued
+    void dispose(asio::io_service& io)
+    {
+        auto self = ptr();
+
+        io.post([self]() {
+            service::get().remove(self);
+        });
+    }
+
     postponer postpone()
     { return postponer{ *this }; }
 
@@ -7,15 +7,22 @@
 
 namespace nx {
 
+class object_registry;
+
 class NX_API object_base
 : public std::enable_shared_from_this<object_base>
 {
 public:
     object_base() = default;
     object_base(const object_base& other) = delete;
-    object_base(object_base&& other) = default;
+    // Registry links belong to the instance, they are never moved
+    object_base(object_base&& other)
+    {}
+
     object_base& operator=(const object_base& other) = delete;
-    object_base& operator=(object_base&& other) = default;
+
+    object_base& operator=(object_base&& other)
+    { return *this; }
 
     std::shared_ptr<object_base> ptr()
     {
@@ -25,6 +32,13 @@ public:
     }
 
     virtual void stop() = 0;
+
+private:
+    friend class object_registry;
+
+    std::shared_ptr<object_base> registered_;
+    object_base* prev_ = nullptr;
+    object_base* next_ = nullptr;
 };
 
 using object_ptr = std::shared_ptr<object_base>;
@@ -0,0 +1,114 @@
+#ifndef __NX_OBJECT_POOL_H__
+#define __NX_OBJECT_POOL_H__
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include <nx/config.h>
+
+namespace nx {
+
+/// @file
+///
+/// Recycled object storage
+
+/// Free list of fixed size memory blocks, one per pooled object type
+///
+/// Pools live until the process exits, so that objects released late
+/// (e.g. at service shutdown) still find theirs.
+class NX_API object_pool
+{
+public:
+    static constexpr std::size_t default_max_free = 1024;
+
+    /// Returns the pool of blocks of size bytes
+    static object_pool& get(std::size_t size);
+
+    /// Sets how many free blocks each pool keeps (0 disables pooling)
+    static void set_max_free(std::size_t count);
+
+    static std::size_t max_free();
+
+    /// Frees pooled blocks of all pools
+    static void trim_all();
+
+    void* acquire();
+    void release(void* p);
+
+    /// Frees all pooled blocks
+    void trim();
+
+    /// Number of free blocks
+    std::size_t size();
+
+private:
+    object_pool(std::size_t size);
+    object_pool(const object_pool&) = delete;
+    void operator=(const object_pool&) = delete;
+
+    std::size_t size_;
+    std::mutex m_;
+    std::vector<void*> free_;
+};
+
+/// Allocator drawing single objects from their object_pool, for use with
+/// std::allocate_shared
+template <typename T>
+struct pool_allocator
+{
+    using value_type = T;
+
+    pool_allocator() = default;
+
+    template <typename U>
+    pool_allocator(const pool_allocator<U>&)
+    {}
+
+    T* allocate(std::size_t n)
+    {
+        static_assert(
+            alignof(T) <= alignof(std::max_align_t),
+            "over-aligned types can't be pooled"
+        );
+
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        return static_cast<T*>(pool().acquire());
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        if (n != 1) {
+            ::operator delete(p);
+            return;
+        }
+
+        pool().release(p);
+    }
+
+    static object_pool& pool()
+    {
+        static object_pool& p = object_pool::get(sizeof(T));
+        return p;
+    }
+};
+
+template <typename T, typename U>
+bool
+operator==(const pool_allocator<T>&, const pool_allocator<U>&)
+{ return true; }
+
+template <typename T, typename U>
+bool
+operator!=(const pool_allocator<T>&, const pool_allocator<U>&)
+{ return false; }
+
+} // namespace nx
+
+#endif // __NX_OBJECT_POOL_H__
@@ -0,0 +1,55 @@
+#ifndef __NX_OBJECT_REGISTRY_H__
+#define __NX_OBJECT_REGISTRY_H__
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+#include <nx/config.h>
+#include <nx/object_base.hpp>
+
+namespace nx {
+
+/// @file
+///
+/// Sharded registry of live objects
+
+/// Keeps objects alive until removed, in intrusive lists spread over
+/// independently locked shards
+///
+/// add() and remove() are O(1) and only contend with objects of the same
+/// shard, remove() of an object which is not registered does nothing.
+class NX_API object_registry
+{
+public:
+    static constexpr std::size_t shard_count = 64;
+
+    object_registry() = default;
+    ~object_registry();
+
+    object_registry(const object_registry&) = delete;
+    void operator=(const object_registry&) = delete;
+
+    void add(object_ptr sptr);
+    void remove(const object_ptr& sptr);
+
+    /// Returns all registered objects
+    std::vector<object_ptr> objects();
+
+    void clear();
+
+private:
+    struct alignas(64) shard
+    {
+        std::mutex m;
+        object_base* head = nullptr;
+    };
+
+    shard& shard_of(const object_base* o);
+
+    std::array<shard, shard_count> shards_;
+};
+
+} // namespace nx
+
+#endif // __NX_OBJECT_REGISTRY_H__
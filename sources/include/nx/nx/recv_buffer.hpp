@@ -0,0 +1,100 @@
+#ifndef __NX_RECV_BUFFER_H__
+#define __NX_RECV_BUFFER_H__
+
+#include <nx/config.h>
+#include <nx/buffer.hpp>
+
+namespace nx {
+
+/// @file
+///
+/// Receive buffer with read/write cursors
+
+/// Socket receive buffer
+///
+/// Consuming data only moves the read cursor, input may be consumed while
+/// a read is writing at the address prepare() returned. Cursors are
+/// rewound, and unread data moved back to the front of the storage, by
+/// prepare() only. Storage comes from and goes back to the buffer_pool.
+class NX_API recv_buffer
+{
+public:
+    using iterator = char*;
+    using const_iterator = const char*;
+
+    recv_buffer() = default;
+    recv_buffer(const recv_buffer& other) = delete;
+    recv_buffer(recv_buffer&& other);
+    ~recv_buffer();
+
+    recv_buffer& operator=(const recv_buffer& other) = delete;
+    recv_buffer& operator=(recv_buffer&& other);
+
+    char* data()
+    { return storage_.data() + rpos_; }
+
+    const char* data() const
+    { return storage_.data() + rpos_; }
+
+    std::size_t size() const
+    { return wpos_ - rpos_; }
+
+    bool empty() const
+    { return wpos_ == rpos_; }
+
+    std::size_t capacity() const
+    { return storage_.size(); }
+
+    iterator begin()
+    { return data(); }
+
+    const_iterator begin() const
+    { return data(); }
+
+    iterator end()
+    { return data() + size(); }
+
+    const_iterator end() const
+    { return data() + size(); }
+
+    char& operator[](std::size_t i)
+    { return data()[i]; }
+
+    const char& operator[](std::size_t i) const
+    { return data()[i]; }
+
+    /// Drops n bytes from the front
+    void consume(std::size_t n);
+
+    /// Drops all unread data
+    void clear();
+
+    /// Returns room for n more bytes after unread data
+    char* prepare(std::size_t n);
+
+    /// Appends n bytes previously written at prepare() address
+    void commit(std::size_t n);
+
+    /// Hands storage back to the buffer_pool (no read may be pending)
+    void release();
+
+private:
+    raw_buffer storage_;
+    std::size_t rpos_ = 0;
+    std::size_t wpos_ = 0;
+};
+
+/// Moves all unread data into v
+template <typename T>
+inline
+recv_buffer&
+operator>>(recv_buffer& b, T& v)
+{
+    v.insert(v.end(), b.begin(), b.end());
+    b.clear();
+    return b;
+}
+
+} // namespace nx
+
+#endif // __NX_RECV_BUFFER_H__
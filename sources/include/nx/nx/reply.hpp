@@ -16,6 +16,12 @@
 
 namespace nx {
 
+/// Receives the encoded parts of a streamed reply, in order
+using stream_cb = unique_function<void(nx::data&&)>;
+
+/// Pauses (true) or resumes (false) a streamed request body
+using body_flow_cb = unique_function<void(bool paused)>;
+
 class NX_API reply : public http_msg<reply>
 {
 public:
@@ -28,11 +34,14 @@ public:
 
     operator bool() const;
 
-    bool parse(buffer& b);
-    std::string header_data() const;
+    using http_msg::parse;
+    void write_head(buffer& b) const;
 
     const http_status& code() const;
     bool is_error() const;
+
+    /// Tells if the reply has a Connection: close header
+    bool closes_connection() const;
     const ws_connection& websocket_callback() const;
 
     void postpone();
@@ -40,6 +49,33 @@ public:
 
     void done();
 
+    /// Starts a streamed reply: headers are sent now, then data written
+    /// to the reply goes out on each flush() until done()
+    ///
+    /// Implies postpone(). Replies are chunked, or end with the connection
+    /// for HTTP/1.0 clients.
+    void stream();
+    bool streaming() const;
+    bool chunked() const;
+
+    /// Sends data written since the last flush as one chunk of a
+    /// streamed reply
+    reply& flush();
+
+    /// Connects a streamed reply to its connection (set by servers)
+    void on_stream(stream_cb cb, bool chunked);
+
+    /// Holds parts of a streamed request body until resume_body(), the
+    /// connection stops reading once its receive buffer is full
+    void pause_body();
+    void resume_body();
+
+    /// Connects request body flow control to its connection (set by
+    /// servers)
+    void on_body_flow(body_flow_cb cb);
+
+    void clear();
+
     bool operator==(const http_status& s) const;
     bool operator!=(const http_status& s) const;
 
@@ -52,13 +88,21 @@ public:
 
     using http_msg::operator<<;
 
+protected:
+    std::size_t parse(const char* data, std::size_t size);
+
 private:
     void handle_error();
+    void send(nx::data&& d);
 
     http_status status_;
     bool postponed_;
     bool upgraded_;
+    bool streaming_ = false;
+    bool chunked_ = true;
     void_cbs done_cbs_;
+    stream_cb stream_cb_;
+    body_flow_cb body_flow_cb_;
     ws_connection ws_connection_;
 
     int minor_version_;
@@ -30,10 +30,13 @@ public:
 
     request& operator=(request&& other);
 
-    bool parse(buffer& b);
-    std::string header_data() const;
+    using http_msg::parse;
+    void write_head(buffer& b) const;
 
     const std::string& method() const;
+
+    /// Standard method, verb::other for extension methods
+    nx::verb verb() const;
     const std::string& path() const;
 
     bool has_a(const std::string& name) const;
@@ -45,6 +48,13 @@ public:
 
     request& operator/(const std::string& path);
 
+    /// Path segments captured by the matching route, viewing path()
+    string_ref capture(std::size_t i) const;
+    std::size_t capture_count() const;
+
+    /// Sets captures (done by routers)
+    void captures(const string_ref* c, std::size_t count);
+
     using http_msg::operator<<;
 
     request& operator<<(const nx::method& m);
@@ -54,11 +64,26 @@ public:
     bool is_form() const;
     bool is_upgrade() const;
 
+    /// Tells if the client wants the connection kept open (HTTP/1.1
+    /// default, or an explicit Connection header)
+    bool keep_alive() const;
+
+    /// HTTP minor version of a parsed request
+    int minor_version() const;
+
+    void clear();
+
+protected:
+    std::size_t parse(const char* data, std::size_t size);
+
 private:
     std::string method_;
+    nx::verb verb_ = nx::verb::other;
     std::string path_;
-    attributes attrs_;
+    attributes attrs_{ arena_ };
     std::string empty_;
+    string_ref* captures_ = nullptr;
+    std::size_t capture_count_ = 0;
 
     const char *raw_method_;
     std::size_t raw_method_len_;
@@ -3,49 +3,192 @@
 
 #include <cstring>
 #include <string>
-#include <vector>
+#include <deque>
 #include <unordered_map>
 #include <functional>
+#include <array>
+#include <tuple>
+#include <utility>
 
 #include <nx/config.h>
 #include <nx/request.hpp>
 #include <nx/reply.hpp>
 #include <nx/context.hpp>
+#include <nx/route_param.hpp>
 
 namespace nx {
 
 using route_cb = std::function<
     void(const request& req, buffer& data, reply& rep)
 >;
+using body_part_cb = std::function<
+    void(const request& req, buffer& chunk, reply& rep)
+>;
+
+/// Route handlers getting the request body as it arrives: on_data for each
+/// part, then on_end with an empty body
+struct body_stream
+{
+    body_part_cb on_data;
+    route_cb on_end;
+};
+
+template <typename... Ts>
+class typed_route;
 
 class NX_API route
 {
 public:
     route& operator/(const char* path);
     route& operator/(const std::string& path);
+
+    template <typename T>
+    typed_route<T> operator/(const param<T>& p);
+
     route& operator=(route_cb cb);
     route& operator=(ws_connection ct);
+    route& operator=(body_stream bs);
 
     const std::string& path() const;
 
-    bool match(request& req) const;
+    /// Number of ":name" and "*name" segments in path()
+    std::size_t capture_count() const;
 
     void operator()(const request& req, buffer& data, reply& rep) const;
 
+    void body(const request& req, buffer& chunk, reply& rep) const;
+
     bool ws_hook() const
     { return ws_hook_; }
 
+    bool streams_body() const
+    { return (bool) body_cb_; }
+
+    /// Handler takes typed captures, not attributes
+    bool typed() const
+    { return typed_; }
+
+    /// Called once when a handler is first set, the route is then
+    /// complete (set by servers)
+    void on_ready(void_cb cb);
+
 private:
+    template <typename... Ts>
+    friend class typed_route;
+
     void clean_path();
+    void ready();
 
     std::string path_;
     route_cb route_cb_;
+    body_part_cb body_cb_;
+    void_cb ready_cb_;
 
     bool ws_hook_ = false;
+    bool typed_ = false;
     ws_connection ct_;
 };
 
-using routes = std::vector<route>;
+/// Route with typed captures, parsed before the handler is called with
+/// their values:
+///
+/// hd(GET) / "items" / param<int>("id") =
+///     [](const request& req, buffer& data, reply& rep, int id) { ... };
+template <typename... Ts>
+class typed_route
+{
+public:
+    using positions = std::array<std::size_t, sizeof...(Ts)>;
+
+    typed_route(route& r, const positions& p)
+    : r_(r),
+    positions_(p)
+    {}
+
+    typed_route& operator/(const char* path)
+    {
+        r_ / path;
+        return *this;
+    }
+
+    typed_route& operator/(const std::string& path)
+    {
+        r_ / path;
+        return *this;
+    }
+
+    template <typename T>
+    typed_route<Ts..., T> operator/(const param<T>& p)
+    {
+        typename typed_route<Ts..., T>::positions next;
+
+        std::copy(positions_.begin(), positions_.end(), next.begin());
+        next.back() = r_.capture_count();
+        r_ / (":" + p.name);
+
+        return typed_route<Ts..., T>(r_, next);
+    }
+
+    template <typename Handler>
+    route& operator=(Handler h)
+    {
+        auto p = positions_;
+
+        r_.typed_ = true;
+        r_ = route_cb(
+            [h, p](const request& req, buffer& data, reply& rep) {
+                call(h, p, req, data, rep, std::index_sequence_for<Ts...>());
+            }
+        );
+
+        return r_;
+    }
+
+private:
+    template <typename T>
+    static void get(const request& req, std::size_t pos, T& v)
+    {
+        if (pos >= req.capture_count() || !parse_capture(req.capture(pos), v)) {
+            throw NotFound;
+        }
+    }
+
+    template <typename Handler, std::size_t... I>
+    static void call(
+        const Handler& h,
+        const positions& p,
+        const request& req,
+        buffer& data,
+        reply& rep,
+        std::index_sequence<I...>
+    )
+    {
+        std::tuple<Ts...> values;
+        int unused[] = { 0, (get(req, p[I], std::get<I>(values)), 0)... };
+
+        (void) unused;
+        (void) p;
+
+        h(req, data, rep, std::get<I>(values)...);
+    }
+
+    route& r_;
+    positions positions_;
+};
+
+template <typename T>
+typed_route<T>
+route::operator/(const param<T>& p)
+{
+    typename typed_route<T>::positions pos{ { capture_count() } };
+
+    *this / (":" + p.name);
+
+    return typed_route<T>(*this, pos);
+}
+
+// Routes keep their address as others are added
+using routes = std::deque<route>;
 using routes_map = std::unordered_map<std::string, routes>;
 
 } // namespace nx
@@ -0,0 +1,111 @@
+#ifndef __NX_ROUTE_PARAM_H__
+#define __NX_ROUTE_PARAM_H__
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include <nx/config.h>
+#include <nx/headers.hpp>
+#include <nx/http_status.hpp>
+
+namespace nx {
+
+/// Typed route capture: hd(GET) / "items" / param<int>("id")
+template <typename T>
+struct param
+{
+    explicit param(std::string n)
+    : name(std::move(n))
+    {}
+
+    std::string name;
+};
+
+/// Binary UUID, parsed from its canonical text form
+struct NX_API uuid
+{
+    std::string str() const;
+
+    bool operator==(const uuid& other) const
+    { return bytes == other.bytes; }
+
+    bool operator!=(const uuid& other) const
+    { return bytes != other.bytes; }
+
+    std::array<std::uint8_t, 16> bytes{};
+};
+
+/// Capture parsers return false when text doesn't fit the type (the route
+/// then replies NotFound), or throw an http_status
+///
+/// Other types are supported by declaring parse_capture(string_ref, T&)
+/// next to them.
+NX_API bool parse_capture(string_ref s, std::string& v);
+NX_API bool parse_capture(string_ref s, string_ref& v);
+NX_API bool parse_capture(string_ref s, uuid& v);
+
+/// Integers out of range are a BadRequest
+template <typename T>
+std::enable_if_t<
+    std::is_integral<T>::value && !std::is_same<T, bool>::value,
+    bool
+>
+parse_capture(string_ref s, T& v)
+{
+    using limits = std::numeric_limits<T>;
+
+    bool negative = !s.empty() && s[0] == '-' && limits::is_signed;
+    std::size_t i = negative ? 1 : 0;
+
+    if (i == s.size()) {
+        return false;
+    }
+
+    std::uintmax_t max =
+        negative
+        ? std::uintmax_t(-(limits::min() + 1)) + 1
+        : std::uintmax_t(limits::max());
+    std::uintmax_t n = 0;
+
+    for (; i < s.size(); i++) {
+        if (s[i] < '0' || s[i] > '9') {
+            return false;
+        }
+
+        std::uintmax_t d = s[i] - '0';
+
+        if (n > (max - d) / 10) {
+            throw BadRequest;
+        }
+
+        n = n * 10 + d;
+    }
+
+    v = negative ? T(-std::intmax_t(n - 1) - 1) : T(n);
+
+    return true;
+}
+
+/// Enums parse from their underlying integer unless they have their own
+/// parse_capture()
+template <typename E>
+std::enable_if_t<std::is_enum<E>::value, bool>
+parse_capture(string_ref s, E& v)
+{
+    std::underlying_type_t<E> u;
+
+    if (!parse_capture(s, u)) {
+        return false;
+    }
+
+    v = static_cast<E>(u);
+
+    return true;
+}
+
+} // namespace nx
+
+#endif // __NX_ROUTE_PARAM_H__
@@ -0,0 +1,83 @@
+#ifndef __NX_ROUTER_H__
+#define __NX_ROUTER_H__
+
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+#include <nx/config.h>
+#include <nx/headers.hpp>
+#include <nx/route.hpp>
+
+namespace nx {
+
+/// Routes compiled into a tree of path segments per method, lookups cost
+/// depends on path depth only
+///
+/// Trees of standard methods are indexed by verb, extension methods are
+/// looked up by name.
+///
+/// Static segments are tried first, then ":name" captures, then a trailing
+/// "*name" wildcard capturing the rest of the path.
+class NX_API router
+{
+public:
+    static const std::size_t max_captures = 32;
+
+    /// Throws std::runtime_error if path can't be routed: wildcard not
+    /// ending it, or more than max_captures captures
+    static void check(const std::string& path);
+
+    /// Adds r for method, returns the route already handling the same
+    /// paths if any (r is then ignored), throws like check()
+    const route* add(const std::string& method, const route& r);
+    const route* add(verb v, const route& r);
+
+    /// Finds the route for req, setting its captures (and attributes for
+    /// routes without typed parameters)
+    const route* find(request& req) const;
+
+private:
+    struct target
+    {
+        const route* r = nullptr;
+        std::vector<std::string> captures;
+    };
+
+    struct node
+    {
+        // Sorted by segment
+        std::vector<std::pair<std::string, std::unique_ptr<node>>> statics;
+        std::unique_ptr<node> param;
+        std::unique_ptr<target> wildcard;
+        std::unique_ptr<target> leaf;
+
+        node* child(const std::string& segment);
+        const node* child(string_ref segment) const;
+    };
+
+    struct match
+    {
+        const target* t = nullptr;
+        string_ref captures[max_captures];
+        std::size_t count = 0;
+    };
+
+    static const route* add(node& tree, const route& r);
+
+    static bool find(
+        const node& n,
+        string_ref path,
+        std::size_t pos,
+        match& m
+    );
+
+    std::array<node, verb_count> trees_;
+    std::unordered_map<std::string, node> other_trees_;
+};
+
+} // namespace nx
+
+#endif // __NX_ROUTER_H__
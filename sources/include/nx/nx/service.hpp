@@ -1,37 +1,70 @@
 #ifndef __NX_SERVICE_H__
 #define __NX_SERVICE_H__
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <thread>
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <boost/asio.hpp>
 
 #include <nx/config.h>
 #include <nx/object_base.hpp>
+#include <nx/object_registry.hpp>
+#include <nx/object_pool.hpp>
 #include <nx/handlers.hpp>
+#include <nx/loop.hpp>
 #include <nx/task.hpp>
 
 namespace nx {
 
 namespace asio = boost::asio;
 
+/// Pool of event loops, each one running its own io_service in its own
+/// thread(s)
+///
+/// Objects are bound to the loop whose io_service they were built with
+/// and all their handlers run on it.
 class NX_API service
 {
 public:
     static service& get();
 
+    /// Sets the number of event loops, must be called before the first
+    /// get() (1 by default, 0 means one per core)
+    static void set_loop_count(std::size_t count);
+
+    /// Sets the number of threads running each event loop, must be called
+    /// before the first get()
+    ///
+    /// Sockets run their handlers on a strand when this is more than 1.
+    static void set_threads_per_loop(std::size_t count);
+
     service();
     ~service();
 
     void start();
     void stop();
 
+    std::size_t loop_count() const;
+    std::size_t threads_per_loop() const;
+
+    /// Returns the calling thread event loop, or the first one when
+    /// called from outside the pool, so that calls made from outside
+    /// run in order
     asio::io_service& io_service();
     const asio::io_service& io_service() const;
 
+    /// Returns event loop i io_service
+    asio::io_service& io_service(std::size_t i);
+
+    /// Returns the next event loop in round-robin order
+    asio::io_service& next_io_service();
+
     void add(object_ptr sptr);
     void remove(object_ptr sptr);
 
@@ -44,12 +77,24 @@ private:
     service(const service&) = delete;
     void operator=(const service&) = delete;
 
-    asio::io_service io_service_;
-    asio::io_service::work work_;
-    std::thread t_;
+    struct loop
+    {
+        loop();
+
+        asio::io_service io_service;
+        asio::io_service::work work;
+        std::vector<std::thread> threads;
+    };
+
+    using loop_ptr = std::unique_ptr<loop>;
+
+    void shutdown();
+
+    std::vector<loop_ptr> loops_;
+    std::size_t threads_per_loop_;
+    std::atomic<std::size_t> next_loop_;
 
-    std::unordered_set<object_ptr> objects_;
-    std::mutex objects_mutex_;
+    object_registry objects_;
 
     std::unordered_set<object_ptr> available_tasks_;
     std::unordered_set<object_ptr> runnable_tasks_;
@@ -75,6 +120,22 @@ new_object(Args&&... args)
     return ptr;
 }
 
+/// Like new_object(), with storage recycled through an object_pool, for
+/// short-lived objects created at a high rate (connections)
+template <typename Derived, typename... Args>
+std::shared_ptr<Derived>
+new_pooled_object(Args&&... args)
+{
+    auto ptr = std::allocate_shared<Derived>(
+        pool_allocator<Derived>(),
+        std::forward<Args>(args)...
+    );
+
+    add_object(ptr->ptr());
+
+    return ptr;
+}
+
 NX_API
 void
 stop();
@@ -2,10 +2,14 @@
 #define __NX_SOCKET_H__
 
 #include <string>
+#include <algorithm>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <deque>
+#include <vector>
 #include <atomic>
+#include <condition_variable>
+#include <functional>
 
 #include <boost/asio.hpp>
 
@@ -15,8 +19,12 @@
 #include <nx/endpoint.hpp>
 #include <nx/service.hpp>
 #include <nx/buffer.hpp>
+#include <nx/buffer_pool.hpp>
+#include <nx/recv_buffer.hpp>
 #include <nx/file.hpp>
 #include <nx/data.hpp>
+#include <nx/loop.hpp>
+#include <nx/write_queue.hpp>
 
 namespace nx {
 
@@ -34,13 +42,57 @@ const on_close_tag on_close = {};
 
 } // namespace tags
 
-enum class write_cmd
+/// Non-owning view over gathered buffers, cheap to copy into asio write
+/// operations
+struct gather_view
 {
-    buffer,
-    file
+    using value_type = asio::const_buffer;
+    using const_iterator = std::vector<asio::const_buffer>::const_iterator;
+
+    const_iterator begin() const
+    { return b; }
+
+    const_iterator end() const
+    { return e; }
+
+    const_iterator b;
+    const_iterator e;
 };
 
-using write_cmd_queue = std::queue<write_cmd>;
+/// Completion handler running h on a strand, or directly when there's no
+/// strand
+template <typename Handler>
+struct strand_handler
+{
+    template <typename... Args>
+    void operator()(Args&&... args)
+    {
+        if (strand) {
+            strand->dispatch(std::bind(h, std::forward<Args>(args)...));
+        } else {
+            h(std::forward<Args>(args)...);
+        }
+    }
+
+    asio::io_service::strand* strand;
+    object_ptr self;
+    Handler h;
+};
+
+// Runs intermediate handlers of composed operations (async_write...) on
+// the strand too
+template <typename Function, typename Handler>
+inline
+void
+asio_handler_invoke(Function&& f, strand_handler<Handler>* h)
+{
+    if (h->strand) {
+        // Plain lambda so that dispatching doesn't come back here
+        h->strand->dispatch([f = std::forward<Function>(f)]() mutable { f(); });
+    } else {
+        f();
+    }
+}
 
 template <
     typename Derived,
@@ -67,7 +119,11 @@ public:
     >;
     using socket_type = Socket;
 
-    static constexpr std::size_t default_read_size = 10 * 1024 * 1024;
+    static constexpr std::size_t max_gather_buffers = 64;
+    static constexpr std::size_t max_gather_bytes = 256 * 1024;
+    static constexpr std::size_t max_accept_batch = 16;
+    static constexpr std::size_t default_read_high = 4 * 1024 * 1024;
+    static constexpr std::size_t default_read_low = 1024 * 1024;
 
     socket()
     : socket_(service::get().io_service())
@@ -102,6 +158,33 @@ public:
     virtual ~socket()
     {}
 
+    /// Runs all handlers of this socket through an asio strand, so that
+    /// its io_service may be run by several threads
+    ///
+    /// Must be called before the socket is started, on a socket owned by
+    /// a shared_ptr (pending handlers keep it alive). Sockets are
+    /// serialized by default when service loops run more than one thread.
+    void serialize()
+    {
+        if (!strand_) {
+            strand_ = std::make_unique<strand_type>(socket_.get_io_service());
+        }
+    }
+
+    bool serialized() const
+    { return (bool) strand_; }
+
+    /// Wraps a completion handler so that it runs on the socket strand
+    template <typename Handler>
+    strand_handler<Handler> wrap(Handler h)
+    {
+        if (!strand_) {
+            return strand_handler<Handler>{ nullptr, nullptr, std::move(h) };
+        }
+
+        return strand_handler<Handler>{ strand_.get(), this->ptr(), std::move(h) };
+    }
+
     socket_type& sock()
     { return socket_; }
 
@@ -111,7 +194,8 @@ public:
     virtual void start()
     {
         cancel_ = false;
-        base_type::postpone(socket_.get_io_service()) << [this]() { read(); };
+        read_paused_ = false;
+        dispatch([this]() { read(); });
     }
 
     virtual void stop()
@@ -161,46 +245,266 @@ public:
     operator<<(const nx::file& f)
     { return push_write(f); }
 
-protected:
-    this_type& push_write(const file& f)
+    /// Pauses reads when unconsumed input or pending output reaches high
+    /// bytes, resumes once both are under low (a 0 high disables pausing)
+    void read_watermarks(std::size_t high, std::size_t low)
     {
-        return start_write(
+        read_high_ = high;
+        read_low_ = std::min(low, high);
+    }
+
+    /// Lets input grow up to n bytes whatever the high watermark, for
+    /// protocols waiting for a whole message (0 when done)
+    void expect_input(std::size_t n)
+    { expected_input_ = n; }
+
+    bool read_paused() const
+    { return read_paused_; }
+
+    /// Limits output waiting to be written to bytes and frames (0 for no
+    /// limit), policy tells what happens to writes beyond them
+    ///
+    /// Limits are approximate when several threads write concurrently.
+    /// They may be changed at any time, writes already queued included.
+    void write_limits(std::size_t bytes, std::size_t frames, write_policy policy)
+    {
+        max_queued_bytes_ = bytes;
+        max_queued_frames_ = frames;
+        write_policy_ = policy;
+    }
+
+    /// Bytes pushed and not written yet
+    std::size_t queued_bytes() const
+    { return queued_bytes_; }
+
+    /// Writes pushed and not written yet
+    std::size_t queued_frames() const
+    { return queued_frames_; }
+
+    /// Tells if queued output is under write limits, on_drain fires once
+    /// everything is written
+    bool writable() const
+    {
+        return
+            (max_queued_bytes_ == 0 || queued_bytes_ < max_queued_bytes_)
+            &&
+            (max_queued_frames_ == 0 || queued_frames_ < max_queued_frames_);
+    }
+
+    /// Resumes paused reads if input and output went under the low
+    /// watermark
+    void resume_read()
+    { dispatch([this]() { try_resume_read(); }); }
+
+    /// Holds writes while cb runs so that everything it pushes goes out
+    /// in a single gathered write
+    template <typename Callable>
+    this_type& batch(Callable cb)
+    {
+        batch_++;
+        cb();
+
+        if (--batch_ == 0) {
+            start_write();
+        }
+
+        return *this;
+    }
+
+    /// Like batch(), and also corks the socket until everything cb
+    /// pushes is written
+    template <typename Callable>
+    this_type& corked(Callable cb)
+    {
+        return batch(
             [&]() {
-                wcq_.emplace(write_cmd::file);
-                fq_.emplace(f);
+                push_control(write_cmd::cork);
+                cb();
+                push_control(write_cmd::uncork);
             }
         );
     }
 
+protected:
+    this_type& push_write(const file& f)
+    { return push_write(std::make_unique<write_item>(f)); }
+
     template <typename Iterator>
     this_type& push_write(Iterator b, Iterator e)
+    { return push_write(std::make_unique<write_item>(buffer(b, e))); }
+
+    this_type& push_write(buffer&& b)
+    { return push_write(std::make_unique<write_item>(std::move(b))); }
+
+    this_type& push_write(write_item_ptr item)
     {
-        return start_write(
-            [&]() {
-                wcq_.emplace(write_cmd::buffer);
-                bq_.emplace(b, e);
-            }
-        );
+        auto size = item->b.size();
+
+        if (over_write_limits(size) && !make_room(size)) {
+            // Write dropped
+            return *this;
+        }
+
+        queued_bytes_ += size;
+        queued_frames_++;
+        wq_.push(std::move(item));
+
+        if (batch_ == 0) {
+            start_write();
+        }
+
+        return *this;
+    }
+
+    // Control items ignore write limits
+    void push_control(write_cmd cmd)
+    {
+        queued_frames_++;
+        wq_.push(std::make_unique<write_item>(cmd));
+    }
+
+    bool over_write_limits(std::size_t size) const
+    {
+        if (queued_frames_ == 0) {
+            // Always accept at least one write
+            return false;
+        }
+
+        return
+            (max_queued_bytes_ != 0 && queued_bytes_ + size > max_queued_bytes_)
+            ||
+            (max_queued_frames_ != 0 && queued_frames_ >= max_queued_frames_);
+    }
+
+    // Applies write policy, returns false when the new write is dropped
+    bool make_room(std::size_t size)
+    {
+        switch (write_policy_) {
+            case write_policy::drop_newest:
+            return false;
+
+            case write_policy::drop_oldest:
+            drop_oldest(size);
+            return true;
+
+            case write_policy::disconnect:
+            post([this]() { stop(); });
+            return false;
+
+            case write_policy::block:
+            wait_writable(size);
+            return true;
+        }
+
+        return true;
     }
 
-    template <typename T>
-    this_type& push_write(T&& t)
+    void drop_oldest(std::size_t size)
     {
-        return start_write(
-            [this,t = std::move(t)]() {
-                wcq_.emplace(write_cmd::buffer);
-                bq_.emplace(std::move(t));
+        std::lock_guard<std::mutex> lock(pop_m_);
+
+        while (over_write_limits(size)) {
+            auto item = wq_.pop();
+
+            if (!item) {
+                // Only items being written are left
+                break;
             }
+
+            if (item->cmd == write_cmd::uncork) {
+                // Never leave the socket corked
+                derived().cork(false);
+            }
+
+            queued_bytes_ -= item->b.size();
+            queued_frames_--;
+        }
+    }
+
+    void wait_writable(std::size_t size)
+    {
+        if (in_loop(socket_.get_io_service())) {
+            // Blocking here would stop the writer
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(drain_m_);
+
+        drain_cv_.wait(
+            lock,
+            [&]() { return !over_write_limits(size) || stop_ || closed_; }
         );
     }
 
+    void notify_writable()
+    {
+        if (write_policy_ == write_policy::block) {
+            std::lock_guard<std::mutex> lock(drain_m_);
+            drain_cv_.notify_all();
+        }
+    }
+
+    // Consumer side pop, producers may drop queued items too. Always
+    // locked: the policy may change while writes are queued, the lock is
+    // uncontended unless producers drop
+    write_item_ptr pop_write()
+    {
+        std::lock_guard<std::mutex> lock(pop_m_);
+        return wq_.pop();
+    }
+
+    bool write_queue_empty()
+    {
+        std::lock_guard<std::mutex> lock(pop_m_);
+        return wq_.empty();
+    }
+
+    void start_write()
+    {
+        if (writer_active_.exchange(true)) {
+            // Current writer will pick up our data
+            return;
+        }
+
+        // We're the writer now
+        if (strand_) {
+            auto self = this->ptr();
+
+            strand_->dispatch([this,self]() { write(); });
+        } else if (in_loop(socket_.get_io_service())) {
+            write();
+        } else {
+            post([this]() { write(); });
+        }
+    }
+
+    /// Runs cb now when already on the socket loop (or its strand), or
+    /// else posts it
     template <typename Callable>
-    this_type& start_write(Callable cb)
+    void dispatch(Callable&& cb)
     {
-        locked(cb);
-        write();
+        bool inline_call =
+            strand_
+            ? strand_->running_in_this_thread()
+            : in_loop(socket_.get_io_service());
+
+        if (inline_call) {
+            cb();
+        } else {
+            post(std::forward<Callable>(cb));
+        }
+    }
 
-        return *this;
+    /// Queues cb on the socket loop, or on its strand when serialized
+    void post(void_cb&& cb)
+    {
+        if (strand_) {
+            auto self = this->ptr();
+
+            strand_->post(make_posted([self,cb = std::move(cb)]() { cb(); }));
+        } else {
+            base_type::postpone(socket_.get_io_service()) << std::move(cb);
+        }
     }
 
     Derived& derived()
@@ -211,26 +515,28 @@ protected:
     auto& io_service()
     { return socket_.get_io_service(); }
 
-    buffer& rbuf()
+    recv_buffer& rbuf()
     { return rbuf_; }
 
-    const buffer& rbuf() const
+    const recv_buffer& rbuf() const
     { return rbuf_; }
 
     void close_after_write()
     {
-        std::lock_guard<std::mutex> lock(m_);
-
         soft_stop_ = true;
 
-        if (!closed_ && wcq_.empty()) {
-            base_type::postpone(socket_.get_io_service()) << [this]() { close(); };
-        }
+        // Writer will close when it finds the queue empty
+        start_write();
     }
 
     void close()
     {
-        std::lock_guard<std::mutex> lock(m_);
+        if (strand_ && !strand_->running_in_this_thread()) {
+            post([this]() { close(); });
+            return;
+        }
+
+        auto lock = guard();
 
         stop_ = true;
 
@@ -240,14 +546,20 @@ protected:
             socket_.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
             socket_.close();
             closed_ = true;
+            notify_writable();
             base_type::handler(tags::on_close)(derived());
-            base_type::dispose();
+            base_type::dispose(socket_.get_io_service());
         }
     }
 
     void cancel()
     {
-        std::lock_guard<std::mutex> lock(m_);
+        if (strand_ && !strand_->running_in_this_thread()) {
+            post([this]() { cancel(); });
+            return;
+        }
+
+        auto lock = guard();
 
         if (!closed_) {
             error_code ec;
@@ -257,109 +569,225 @@ protected:
     }
 
 private:
-    template <typename Callback>
-    auto locked(Callback cb)
+    using strand_type = asio::io_service::strand;
+    using strand_ptr = std::unique_ptr<strand_type>;
+
+    static bool serialize_by_default()
+    { return service::get().threads_per_loop() > 1; }
+
+    // Strands replace the per-operation lock
+    std::unique_lock<std::mutex> guard()
     {
-        std::lock_guard<std::mutex> lock(m_);
+        if (strand_) {
+            return std::unique_lock<std::mutex>(m_, std::defer_lock);
+        }
 
-        return cb();
+        return std::unique_lock<std::mutex>(m_);
     }
 
     void read()
     {
-        std::lock_guard<std::mutex> lock(m_);
+        auto lock = guard();
 
         if (stop_ || closed_ || cancel_) {
             return;
         }
 
-        buf_.resize(default_read_size);
+        // Read straight into rbuf_ free tail
+        auto size = read_size_();
 
         socket_.async_read_some(
-            asio::buffer(buf_),
-            [&](const error_code& ec, std::size_t count) {
+            asio::buffer(rbuf_.prepare(size), size),
+            wrap([this](const error_code& ec, std::size_t count) {
                 if (handle_error(derived(), "read", ec)) {
                     return;
                 }
 
-                if (count > 0) {
-                    rbuf_.insert(
-                        rbuf_.end(),
-                        buf_.begin(), buf_.begin() + count
-                    );
+                rbuf_.commit(count);
+                read_size_.update(count);
 
-                    buf_.clear();
+                if (count > 0) {
                     base_type::handler(tags::on_read)(derived());
                 }
 
-                base_type::postpone(socket_.get_io_service()) << [&]() { read(); };
+                recycle_read();
 
-            }
+                if (read_over_high()) {
+                    // Wait for input to be consumed or output drained
+                    read_paused_ = true;
+                    return;
+                }
+
+                read();
+            })
         );
     }
 
-    void write()
+    bool read_over_high() const
+    {
+        if (read_high_ == 0) {
+            return false;
+        }
+
+        return
+            rbuf_.size() >= std::max(read_high_, expected_input_)
+            ||
+            queued_bytes_ >= read_high_;
+    }
+
+    bool read_under_low() const
+    {
+        return
+            rbuf_.size() < std::max(read_low_, expected_input_)
+            &&
+            queued_bytes_ <= read_low_;
+    }
+
+    // Runs on the socket loop (or strand)
+    void try_resume_read()
+    {
+        if (read_paused_ && read_under_low()) {
+            read_paused_ = false;
+            read();
+        }
+    }
+
+    void recycle_read()
     {
-        std::lock_guard<std::mutex> lock(m_);
+        // Give oversized storage back when traffic calms down
+        if (rbuf_.empty() && rbuf_.capacity() > 2 * read_size_()) {
+            rbuf_.release();
+        }
+    }
 
-        if (stop_ || closed_ || writing_ || cancel_) {
+    void write()
+    {
+        if (stop_ || closed_ || cancel_) {
+            writer_active_ = false;
             return;
         }
 
-        if (wcq_.empty()) {
-            if (soft_stop_) {
-                base_type::postpone(socket_.get_io_service()) << [&]() { stop(); };
+        if (!stage()) {
+            writer_active_ = false;
+
+            if (!write_queue_empty()) {
+                // A producer raced with us, or is still linking its item
+                // after finding us active: go on unless it took over
+                if (!writer_active_.exchange(true)) {
+                    post([this]() { write(); });
+                }
+            } else if (soft_stop_) {
+                stop();
             } else {
-                base_type::postpone(socket_.get_io_service()) << [&]() {
-                    base_type::handler(tags::on_drain)(derived());
-                };
+                try_resume_read();
+                base_type::handler(tags::on_drain)(derived());
             }
 
             return;
         }
 
-        writing_ = true;
-
-        switch (wcq_.front()) {
+        switch (pending_.front()->cmd) {
             case write_cmd::buffer:
-            write_buffer();
+            write_buffers();
             break;
             case write_cmd::file:
             write_file();
             break;
+            case write_cmd::cork:
+            case write_cmd::uncork:
+            write_control();
+            break;
+        }
+    }
+
+    void write_control()
+    {
+        derived().cork(pending_.front()->cmd == write_cmd::cork);
+
+        queued_frames_--;
+        pending_.erase(pending_.begin());
+
+        write();
+    }
+
+    // Moves at least one queued item to pending_
+    bool stage()
+    {
+        if (pending_.empty()) {
+            if (auto item = pop_write()) {
+                pending_.emplace_back(std::move(item));
+            }
         }
+
+        return !pending_.empty();
     }
 
-    void write_buffer()
+    void write_buffers()
     {
-        buffer& b = bq_.front();
+        // Gather consecutive queued buffers into a single write
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+
+        gather_.clear();
+
+        while (count < max_gather_buffers && bytes < max_gather_bytes) {
+            if (count == pending_.size()) {
+                auto item = pop_write();
+
+                if (!item) {
+                    break;
+                }
+
+                pending_.emplace_back(std::move(item));
+            }
+
+            const auto& item = *pending_[count];
+
+            if (item.cmd != write_cmd::buffer) {
+                break;
+            }
+
+            gather_.emplace_back(asio::buffer(item.b));
+            bytes += item.b.size();
+            count++;
+        }
 
         asio::async_write(
             socket_,
-            asio::buffer(b),
-            [this](const error_code& ec, std::size_t count) {
-                handle_write("write_buffer", ec, bq_);
-            }
+            gather_view{ gather_.begin(), gather_.end() },
+            wrap([this,count](const error_code& ec, std::size_t) {
+                handle_write("write_buffer", ec, count);
+            })
         );
     }
 
     void write_file()
     {
-        const file& f = fq_.front();
+        const file& f = pending_.front()->f;
 
         send_file(
             *this,
             f,
-            [this](const error_code& ec, std::size_t count) {
-                handle_write("send_file", ec, fq_);
-            }
+            wrap([this](const error_code& ec, std::size_t count) {
+                handle_write("send_file", ec, 1);
+            })
         );
     }
 
-    template <typename Queue>
-    void handle_write(const char* what, const error_code& ec, Queue& q)
+    void handle_write(const char* what, const error_code& ec, std::size_t count)
     {
-        locked([&]() { pop_queue(wcq_); pop_queue(q); });
+        auto& pool = buffer_pool::get();
+
+        for (std::size_t i = 0; i < count; i++) {
+            queued_bytes_ -= pending_[i]->b.size();
+            pool.release(pending_[i]->b);
+        }
+
+        queued_frames_ -= count;
+        pending_.erase(pending_.begin(), pending_.begin() + count);
+        notify_writable();
+
+        try_resume_read();
 
         bool write_next = true;
 
@@ -371,33 +799,41 @@ private:
             write_next = false;
         }
 
-        writing_ = false;
-
         if (write_next) {
-            base_type::postpone(socket_.get_io_service()) << [this](){ write(); };
-        }
-    }
-
-    template <typename Queue>
-    void pop_queue(Queue& q)
-    {
-        if (!q.empty()) {
-            q.pop();
+            write();
         }
     }
 
     socket_type socket_;
-    buffer buf_;
-    buffer rbuf_;
-    std::atomic_bool writing_{ false };
+    strand_ptr strand_{
+        serialize_by_default()
+        ? std::make_unique<strand_type>(socket_.get_io_service())
+        : nullptr
+    };
+    recv_buffer rbuf_;
+    read_size read_size_;
+    std::size_t read_high_ = default_read_high;
+    std::size_t read_low_ = default_read_low;
+    std::size_t expected_input_ = 0;
+    std::atomic_bool read_paused_{ false };
+    std::atomic<std::size_t> queued_bytes_{ 0 };
+    std::atomic<std::size_t> queued_frames_{ 0 };
+    std::atomic<std::size_t> max_queued_bytes_{ 0 };
+    std::atomic<std::size_t> max_queued_frames_{ 0 };
+    std::atomic<write_policy> write_policy_{ write_policy::drop_newest };
+    std::atomic_bool writer_active_{ false };
+    std::atomic_int batch_{ 0 };
     std::atomic_bool stop_{ false };
     std::atomic_bool soft_stop_{ false };
     std::atomic_bool closed_{ false };
     std::atomic_bool cancel_{ false };
-    write_cmd_queue wcq_;
-    buffer_queue bq_;
-    file_queue fq_;
+    write_queue wq_;
+    std::deque<write_item_ptr> pending_;
+    std::vector<asio::const_buffer> gather_;
     std::mutex m_;
+    std::mutex pop_m_;
+    std::mutex drain_m_;
+    std::condition_variable drain_cv_;
 };
 
 } // namespace nx
@@ -0,0 +1,57 @@
+#ifndef __NX_SOCKET_OPTIONS_H__
+#define __NX_SOCKET_OPTIONS_H__
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include <boost/asio.hpp>
+#include <boost/optional.hpp>
+
+#include <nx/config.h>
+
+namespace nx {
+
+namespace asio = boost::asio;
+
+/// @file
+///
+/// Typed socket options
+
+/// Socket tuning, unset options are left to system defaults
+///
+/// TCP only options are ignored by local sockets.
+struct socket_options
+{
+    /// Disables Nagle's algorithm (TCP_NODELAY)
+    boost::optional<bool> nodelay;
+
+    /// Holds partial segments until uncorked (TCP_CORK)
+    boost::optional<bool> cork;
+
+    /// Acknowledges immediately (TCP_QUICKACK, reset by the kernel after
+    /// some time)
+    boost::optional<bool> quickack;
+
+    /// SO_SNDBUF
+    boost::optional<int> send_buffer_size;
+
+    /// SO_RCVBUF
+    boost::optional<int> receive_buffer_size;
+};
+
+namespace option {
+
+#ifdef TCP_CORK
+using tcp_cork = asio::detail::socket_option::boolean<IPPROTO_TCP, TCP_CORK>;
+#endif // TCP_CORK
+
+#ifdef TCP_QUICKACK
+using tcp_quickack =
+    asio::detail::socket_option::boolean<IPPROTO_TCP, TCP_QUICKACK>;
+#endif // TCP_QUICKACK
+
+} // namespace option
+
+} // namespace nx
+
+#endif // __NX_SOCKET_OPTIONS_H__
@@ -11,16 +11,22 @@ connect(
     Connected cb
 )
 {
+    if (!s.sock().is_open()) {
+        // Open now so that options apply before the handshake
+        s.sock().open(to.protocol());
+        s.apply_options();
+    }
+
     s.sock().async_connect(
         to,
-        [&s,cb](const error_code& ec) {
+        s.wrap([&s,cb](const error_code& ec) {
             if (handle_error(s, "connect", ec)) {
                 return;
             }
 
             cb(s);
             s.start();
-        }
+        })
     );
 
     return s;
@@ -90,16 +96,57 @@ connect(
     return s;
 }
 
+template <typename Socket>
+asio::io_service&
+accept_io_service(Socket& s, typename Socket::acceptor_type& a)
+{
+    if (s.acceptor_count() > 1) {
+        // Per-loop acceptor, connections stay on its loop
+        return a.get_io_service();
+    }
+
+    // Single acceptor, spread connections over the service event loops
+    return service::get().next_io_service();
+}
+
 template <typename Socket, typename Accepted, typename Read>
 void
-accept(Socket& s, Accepted accept_cb, Read read_cb)
+accepted(
+    Socket& s,
+    typename Socket::socket_type&& peer,
+    Accepted& accept_cb,
+    Read& read_cb
+)
 {
-    auto& a = s.acceptor();
+    auto cs_ptr = new_pooled_object<Socket>(std::move(peer));
+    auto& cs = *cs_ptr;
+
+    cs.sock().non_blocking();
+    cs.inherit_options(s);
+    cs[tags::on_read] = read_cb;
+    // Callbacks must be in place before reads start on the
+    // connection event loop
+    accept_cb(cs);
+    cs.start();
+}
+
+template <typename Socket, typename Accepted, typename Read>
+void
+accept(
+    Socket& s,
+    typename Socket::acceptor_type& a,
+    Accepted accept_cb,
+    Read read_cb
+)
+{
+    using socket_type = typename Socket::socket_type;
+
+    auto peer = std::make_shared<socket_type>(accept_io_service(s, a));
 
     a.async_accept(
-        s.sock(),
-        [&s,accept_cb,read_cb](const error_code& ec) {
-            if (!s.acceptor().is_open()) {
+        *peer,
+        [&s,&a,peer,accept_cb,read_cb](const error_code& ec) mutable {
+            if (!a.is_open()) {
                 return;
             }
 
@@ -107,19 +154,39 @@ accept(Socket& s, Accepted accept_cb, Read read_cb)
                 return;
             }
 
-            auto cs_ptr = new_object<Socket>(std::move(s.sock()));
-            auto& cs = *cs_ptr;
+            accepted(s, std::move(*peer), accept_cb, read_cb);
 
-            cs.sock().non_blocking();
-            cs[tags::on_read] = read_cb;
-            cs.start();
-            accept_cb(cs);
+            // Drain the backlog before waiting again, the acceptor is
+            // non-blocking
+            for (std::size_t i = 1; i < Socket::max_accept_batch; i++) {
+                socket_type next(accept_io_service(s, a));
+                error_code aec;
 
-            accept(s, accept_cb, read_cb);
+                a.accept(next, aec);
+
+                if (aec) {
+                    // Nothing left (or a real error, async_accept will
+                    // report it)
+                    break;
+                }
+
+                accepted(s, std::move(next), accept_cb, read_cb);
+            }
+
+            accept(s, a, accept_cb, read_cb);
         }
     );
 }
 
+template <typename Socket, typename Accepted, typename Read>
+void
+accept(Socket& s, Accepted accept_cb, Read read_cb)
+{
+    for (std::size_t i = 0; i < s.acceptor_count(); i++) {
+        accept(s, s.acceptor(i), accept_cb, read_cb);
+    }
+}
+
 template <typename Socket, typename Accepted, typename Read>
 typename Socket::endpoint_type
 serve(
@@ -129,16 +196,43 @@ serve(
     Read read_cb
 )
 {
-    auto& a = s.make_acceptor();
+    auto& svc = service::get();
+    std::size_t count = 1;
+
+    if (Socket::per_loop_acceptors) {
+        count = svc.loop_count();
+    }
+
+    auto ep = from;
+
+    for (std::size_t i = 0; i < count; i++) {
+        auto& a =
+            count == 1
+            ? s.make_acceptor()
+            : i == 0
+            ? s.make_acceptor(svc.io_service(i))
+            : s.add_acceptor(svc.io_service(i));
+
+        a.open(ep.protocol());
+        s.reuse_addr(a, ep);
 
-    a.open(from.protocol());
-    s.reuse_addr(a, from);
-    a.bind(from);
-    a.listen();
+        if (count > 1) {
+            s.reuse_port(a);
+        }
+
+        a.bind(ep);
+        a.listen();
+        a.non_blocking(true);
+
+        if (i == 0) {
+            // Others bind the same port, even when from asked for any
+            ep = a.local_endpoint();
+        }
+    }
 
     accept(s, accept_cb, read_cb);
 
-    return a.local_endpoint();
+    return ep;
 }
 
 template <typename Socket, typename Accepted, typename Read>
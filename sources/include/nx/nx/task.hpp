@@ -11,6 +11,7 @@
 #include <nx/config.h>
 #include <nx/object_base.hpp>
 #include <nx/handlers.hpp>
+#include <nx/loop.hpp>
 
 namespace nx {
 
@@ -24,7 +25,7 @@ public:
     : io_service_(),
       work_(io_service_),
       t_([this](){ 
-          io_service_.run();
+          run_loop(io_service_);
           io_service_.reset(); 
       })
     {}
@@ -2,8 +2,10 @@
 #define __NX_TCP_H__
 
 #include <sstream>
+#include <vector>
 
 #include <nx/socket.hpp>
+#include <nx/socket_options.hpp>
 #include <nx/socket_template_functions.hpp>
 
 namespace nx {
@@ -27,6 +29,14 @@ public:
     using endpoint_type = asio::ip::tcp::endpoint;
     using resolver_type = asio::ip::tcp::resolver;
 
+#ifdef SO_REUSEPORT
+    /// One SO_REUSEPORT acceptor per event loop, the kernel balances
+    /// incoming connections between them
+    static constexpr bool per_loop_acceptors = true;
+#else
+    static constexpr bool per_loop_acceptors = false;
+#endif // SO_REUSEPORT
+
     using base_type::base_type;
 
     tcp_base() = default;
@@ -64,19 +74,31 @@ public:
     }
 
     acceptor_type& make_acceptor()
+    { return make_acceptor(base_type::io_service()); }
+
+    /// Replaces acceptors with a single one running on io
+    acceptor_type& make_acceptor(asio::io_service& io)
     {
-        acceptor_ptr_ = std::make_unique<acceptor_type>(
-            base_type::io_service()
-        );
+        acceptors_.clear();
+
+        return add_acceptor(io);
+    }
+
+    acceptor_type& add_acceptor(asio::io_service& io)
+    {
+        acceptors_.emplace_back(std::make_unique<acceptor_type>(io));
 
-        return *acceptor_ptr_;
+        return *acceptors_.back();
     }
 
-    acceptor_type& acceptor()
-    { return *acceptor_ptr_; }
+    std::size_t acceptor_count() const
+    { return acceptors_.size(); }
 
-    const acceptor_type& acceptor() const
-    { return *acceptor_ptr_; }
+    acceptor_type& acceptor(std::size_t i = 0)
+    { return *acceptors_[i]; }
+
+    const acceptor_type& acceptor(std::size_t i = 0) const
+    { return *acceptors_[i]; }
 
     resolver_type& make_resolver()
     {
@@ -98,12 +120,97 @@ public:
         a.set_option(asio::ip::tcp::acceptor::reuse_address(true));
     }
 
+    void reuse_port(acceptor_type& a)
+    {
+#ifdef SO_REUSEPORT
+        a.set_option(reuse_port_option(true));
+#endif // SO_REUSEPORT
+    }
+
+    /// Sets options, applied now if the socket is open, or else when it
+    /// connects, and inherited by accepted connections
+    void options(const socket_options& o)
+    {
+        options_ = o;
+        apply_options();
+    }
+
+    const socket_options& options() const
+    { return options_; }
+
+    void inherit_options(const Derived& listener)
+    { options(listener.options()); }
+
+    void apply_options()
+    {
+        if (!base_type::sock().is_open()) {
+            return;
+        }
+
+        if (options_.nodelay) {
+            nodelay(*options_.nodelay);
+        }
+
+        if (options_.cork) {
+            cork(*options_.cork);
+        }
+
+        if (options_.quickack) {
+            quickack(*options_.quickack);
+        }
+
+        if (options_.send_buffer_size) {
+            send_buffer_size(*options_.send_buffer_size);
+        }
+
+        if (options_.receive_buffer_size) {
+            receive_buffer_size(*options_.receive_buffer_size);
+        }
+    }
+
+    void nodelay(bool flag)
+    { set_option(asio::ip::tcp::no_delay(flag)); }
+
+    void cork(bool flag)
+    {
+#ifdef TCP_CORK
+        set_option(option::tcp_cork(flag));
+#endif // TCP_CORK
+    }
+
+    void quickack(bool flag)
+    {
+#ifdef TCP_QUICKACK
+        set_option(option::tcp_quickack(flag));
+#endif // TCP_QUICKACK
+    }
+
+    void send_buffer_size(int size)
+    { set_option(asio::socket_base::send_buffer_size(size)); }
+
+    void receive_buffer_size(int size)
+    { set_option(asio::socket_base::receive_buffer_size(size)); }
+
 private:
+    template <typename Option>
+    void set_option(const Option& o)
+    {
+        // Tuning failures aren't fatal
+        error_code ec;
+        base_type::sock().set_option(o, ec);
+    }
+
+#ifdef SO_REUSEPORT
+    using reuse_port_option =
+        asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif // SO_REUSEPORT
+
     using acceptor_ptr = std::unique_ptr<acceptor_type>;
     using resolver_ptr = std::unique_ptr<resolver_type>;
 
-    acceptor_ptr acceptor_ptr_;
+    std::vector<acceptor_ptr> acceptors_;
     resolver_ptr resolver_ptr_;
+    socket_options options_;
 };
 
 class tcp : public tcp_base<tcp>
@@ -17,7 +17,7 @@ using timestamp = asio::system_timer::duration;
 class NX_API timer : public object<timer>
 {
 public:
-    using timer_cb = std::function<
+    using timer_cb = unique_function<
         void(timer& t)
     >;
 
@@ -0,0 +1,93 @@
+#ifndef __NX_WRITE_QUEUE_H__
+#define __NX_WRITE_QUEUE_H__
+
+#include <atomic>
+#include <memory>
+
+#include <nx/config.h>
+#include <nx/buffer.hpp>
+#include <nx/file.hpp>
+
+namespace nx {
+
+/// @file
+///
+/// Lock-free multi-producer/single-consumer socket write queue
+
+enum class write_cmd
+{
+    buffer,
+    file,
+    cork,
+    uncork
+};
+
+/// What a socket does with writes beyond its write limits
+enum class write_policy
+{
+    drop_newest, ///< Discard the new write
+    drop_oldest, ///< Discard queued writes, oldest first
+    disconnect, ///< Discard the new write and close the socket
+    block ///< Wait for room (never blocks the socket event loop)
+};
+
+/// Tagged write command
+struct write_item
+{
+    write_item() = default;
+
+    write_item(buffer&& data)
+    : cmd(write_cmd::buffer),
+    b(std::move(data))
+    {}
+
+    write_item(const file& data)
+    : cmd(write_cmd::file),
+    f(data)
+    {}
+
+    write_item(write_cmd control)
+    : cmd(control)
+    {}
+
+    write_cmd cmd = write_cmd::buffer;
+    buffer b;
+    file f;
+    std::atomic<write_item*> next{ nullptr };
+};
+
+using write_item_ptr = std::unique_ptr<write_item>;
+
+/// Intrusive MPSC queue (D. Vyukov's algorithm)
+///
+/// push() may be called from any thread, pop() and empty() only from the
+/// consumer.
+class NX_API write_queue
+{
+public:
+    write_queue();
+    ~write_queue();
+
+    write_queue(const write_queue&) = delete;
+    void operator=(const write_queue&) = delete;
+
+    void push(write_item_ptr item);
+
+    /// Returns the oldest item, or nullptr when the queue is empty or a
+    /// producer is half-way through a push
+    write_item_ptr pop();
+
+    /// Tells if nothing is queued, items still being pushed included
+    bool empty() const;
+
+private:
+    void push(write_item* item);
+
+    std::atomic<write_item*> head_;
+    write_item* tail_;
+    write_item stub_;
+};
+
+} // namespace nx
+
+#endif // __NX_WRITE_QUEUE_H__
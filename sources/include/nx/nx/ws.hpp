@@ -129,29 +129,35 @@ class NX_API ws
         }
 
         if (b.size() < hlen + len) {
+            // Keep reading until the whole frame is there
+            this->expect_input(hlen + len);
             return false;
         }
 
-        // Remove header bytes
-        b.erase(b.begin(), b.begin() + hlen);
+        this->expect_input(0);
 
         // Payload
         if (masked) {
             // Extract mask
-            uint32_t mask = le32toh(*((uint32_t*) b.data()));
+            uint32_t mask = le32toh(*((uint32_t*) (data + hlen)));
             auto mask_data = (uint8_t*) &mask;
-            b.erase(b.begin(), b.begin() + 4);
+            auto payload = data + hlen + 4;
 
-            f.payload.resize(b.size());
+            len -= 4;
+            f.payload.resize(len);
 
-            for (std::size_t i = 0; i < b.size(); i++) {
-                f.payload[i] = b[i] ^ mask_data[i % 4];
+            for (std::size_t i = 0; i < len; i++) {
+                f.payload[i] = payload[i] ^ mask_data[i % 4];
             }
+
+            hlen += 4;
         } else {
-            f.payload << b;
+            f.payload.assign(data + hlen, data + hlen + len);
         }
 
-        b.clear();
+        // Frame fully read
+        b.consume(hlen + len);
+
         return true;
     }
 
@@ -245,8 +251,9 @@ class NX_API ws
     }
 
 
+    // Closed on the socket loop, whoever asks
     void stop_socket()
-    { stop(); }
+    { this->post([this]() { this->stop(); }); }
 
     void push_in_socket(buffer&& b)
     { (*this) << std::move(b);}
@@ -257,6 +264,15 @@ class NX_API ws
     void push_in_socket(std::string& s)
     { (*this) << s;}
 
+    void write_limits(std::size_t bytes, std::size_t frames, write_policy policy)
+    { base_type::write_limits(bytes, frames, policy); }
+
+    std::size_t queued_bytes() const
+    { return base_type::queued_bytes(); }
+
+    bool writable() const
+    { return base_type::writable(); }
+
 private:
     void finish(uint16_t code)
     {
@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <new>
+
+#include <nx/arena.hpp>
+#include <nx/object_pool.hpp>
+
+namespace nx {
+
+constexpr std::size_t arena::chunk_size;
+
+arena::~arena()
+{
+    while (chunks_) {
+        auto c = chunks_;
+        chunks_ = c->next;
+        free_chunk(c);
+    }
+}
+
+void*
+arena::allocate(std::size_t size, std::size_t align)
+{
+    auto p = reinterpret_cast<std::uintptr_t>(cur_);
+    auto aligned = (p + align - 1) & ~(std::uintptr_t) (align - 1);
+
+    if (!cur_ || aligned + size > reinterpret_cast<std::uintptr_t>(end_)) {
+        add_chunk(size + align);
+
+        p = reinterpret_cast<std::uintptr_t>(cur_);
+        aligned = (p + align - 1) & ~(std::uintptr_t) (align - 1);
+    }
+
+    cur_ = reinterpret_cast<char*>(aligned + size);
+
+    return reinterpret_cast<void*>(aligned);
+}
+
+void
+arena::reset()
+{
+    // Keep the oldest chunk, the one regular cycles fit in
+    while (chunks_ && chunks_->next) {
+        auto c = chunks_;
+        chunks_ = c->next;
+        free_chunk(c);
+    }
+
+    if (chunks_ && chunks_->size != chunk_size) {
+        free_chunk(chunks_);
+        chunks_ = nullptr;
+    }
+
+    if (chunks_) {
+        cur_ = reinterpret_cast<char*>(chunks_ + 1);
+        end_ = reinterpret_cast<char*>(chunks_) + chunks_->size;
+    } else {
+        cur_ = nullptr;
+        end_ = nullptr;
+    }
+}
+
+void
+arena::add_chunk(std::size_t size)
+{
+    std::size_t total = chunk_size;
+    void* p = nullptr;
+
+    if (size + sizeof(chunk) > chunk_size) {
+        total = size + sizeof(chunk);
+        p = ::operator new(total);
+    } else {
+        p = object_pool::get(chunk_size).acquire();
+    }
+
+    auto c = ::new (p) chunk{ chunks_, total };
+
+    chunks_ = c;
+    cur_ = reinterpret_cast<char*>(c + 1);
+    end_ = reinterpret_cast<char*>(c) + total;
+}
+
+void
+arena::free_chunk(chunk* c)
+{
+    if (c->size == chunk_size) {
+        object_pool::get(chunk_size).release(c);
+    } else {
+        ::operator delete(c);
+    }
+}
+
+} // namespace nx
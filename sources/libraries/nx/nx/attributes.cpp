@@ -55,6 +55,12 @@ attribute_map::attribute_map(const std::string& data, char sep)
     }
 }
 
+attribute_map::attribute_map(arena& a, char sep)
+: sep_(sep),
+m_(0, map_type::hasher(), map_type::key_equal(), a),
+lcm_(0, map_type::hasher(), map_type::key_equal(), a)
+{}
+
 attribute_map::attribute_map(const attribute_map& other)
 { *this = other; }
 
@@ -110,6 +116,24 @@ attribute_map::has(const std::string& name) const
         ;
 }
 
+bool
+attribute_map::empty() const
+{ return m_.empty(); }
+
+void
+attribute_map::reserve(std::size_t count)
+{
+    m_.reserve(count);
+    lcm_.reserve(count);
+}
+
+void
+attribute_map::clear()
+{
+    m_.clear();
+    lcm_.clear();
+}
+
 std::string&
 attribute_map::operator[](const std::string& name)
 {
@@ -168,6 +192,19 @@ attribute_map::operator<<(attribute_base&& a)
     return *this;
 }
 
+attribute_map&
+attribute_map::replace(const attribute_base& a)
+{
+    auto it = lcm_.find(lc(a.name));
+
+    if (it != lcm_.end()) {
+        m_.erase(it->second);
+        lcm_.erase(it);
+    }
+
+    return *this << a;
+}
+
 attribute_map&
 attribute_map::operator<<(const attribute_map& other)
 {
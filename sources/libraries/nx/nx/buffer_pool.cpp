@@ -0,0 +1,146 @@
+#include <nx/buffer_pool.hpp>
+
+namespace nx {
+
+constexpr std::size_t buffer_pool::min_size;
+constexpr std::size_t buffer_pool::max_size;
+constexpr std::size_t buffer_pool::max_free;
+constexpr std::size_t buffer_pool::class_count;
+constexpr std::size_t read_size::shrink_after;
+
+buffer_pool&
+buffer_pool::get()
+{
+    static buffer_pool bp;
+    return bp;
+}
+
+buffer
+buffer_pool::acquire(std::size_t size)
+{ return acquire(free_, size); }
+
+void
+buffer_pool::release(buffer& b)
+{ release(free_, b); }
+
+raw_buffer
+buffer_pool::acquire_raw(std::size_t size)
+{ return acquire(free_raw_, size); }
+
+void
+buffer_pool::release(raw_buffer& b)
+{ release(free_raw_, b); }
+
+template <typename Buffer>
+Buffer
+buffer_pool::acquire(
+    std::array<std::vector<Buffer>, class_count>& free,
+    std::size_t size
+)
+{
+    Buffer b;
+
+    if (size > max_size) {
+        // Too big to be pooled
+        b.reserve(size);
+        return b;
+    }
+
+    // Smallest class holding size bytes
+    std::size_t c = 0;
+    std::size_t class_size = min_size;
+
+    while (class_size < size) {
+        class_size <<= 1;
+        c++;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_);
+
+        auto& f = free[c];
+
+        if (!f.empty()) {
+            b.swap(f.back());
+            f.pop_back();
+            return b;
+        }
+    }
+
+    b.reserve(class_size);
+
+    return b;
+}
+
+template <typename Buffer>
+void
+buffer_pool::release(
+    std::array<std::vector<Buffer>, class_count>& free,
+    Buffer& b
+)
+{
+    Buffer storage;
+
+    storage.swap(b);
+
+    auto capacity = storage.capacity();
+
+    if (capacity < min_size || capacity > max_size) {
+        return;
+    }
+
+    // Largest class fitting in capacity
+    std::size_t c = 0;
+    std::size_t class_size = min_size;
+
+    while ((class_size << 1) <= capacity) {
+        class_size <<= 1;
+        c++;
+    }
+
+    storage.clear();
+
+    std::lock_guard<std::mutex> lock(m_);
+
+    auto& f = free[c];
+
+    if (f.size() < max_free) {
+        f.emplace_back(std::move(storage));
+    }
+}
+
+void
+buffer_pool::trim()
+{
+    std::lock_guard<std::mutex> lock(m_);
+
+    for (auto& f : free_) {
+        buffers().swap(f);
+    }
+
+    for (auto& f : free_raw_) {
+        raw_buffers().swap(f);
+    }
+}
+
+void
+read_size::update(std::size_t count)
+{
+    if (count >= size_) {
+        // Read filled the buffer, there's probably more
+        short_reads_ = 0;
+
+        if (size_ < buffer_pool::max_size) {
+            size_ <<= 1;
+        }
+    } else if (count < size_ / 4 && size_ > buffer_pool::min_size) {
+        if (++short_reads_ == shrink_after) {
+            short_reads_ = 0;
+            size_ >>= 1;
+        }
+    } else {
+        short_reads_ = 0;
+    }
+}
+
+} // namespace nx
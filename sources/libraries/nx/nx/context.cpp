@@ -88,12 +88,38 @@ context::operator<< (jsonv::value&& v)
 
 void
 context::stop()
-{ 
-    async() << [this]() {
-        if (auto w = w_.lock()) {
-            w->stop_socket();
-        }
-    }; 
+{
+    if (auto w = w_.lock()) {
+        w->stop_socket();
+    }
+}
+
+void
+context::write_limits(std::size_t bytes, std::size_t frames, write_policy policy)
+{
+    if (auto w = w_.lock()) {
+        w->write_limits(bytes, frames, policy);
+    }
+}
+
+std::size_t
+context::queued_bytes() const
+{
+    std::size_t result = 0;
+    if (auto w = w_.lock()) {
+        result = w->queued_bytes();
+    }
+    return result;
+}
+
+bool
+context::writable() const
+{
+    bool result = false;
+    if (auto w = w_.lock()) {
+        result = w->writable();
+    }
+    return result;
 }
 
 std::string 
@@ -8,12 +8,17 @@ std::size_t
 data::size() const
 { return size_; }
 
+bool
+data::has_files() const
+{ return !files_.empty(); }
+
 void
 data::clear()
 {
     items_.clear();
     streams_.clear();
     files_.clear();
+    size_ = 0;
 }
 
 data&
@@ -27,6 +32,60 @@ data::operator<<(const file& f)
     return *this;
 }
 
+data&
+data::operator<<(const data& other)
+{
+    auto sit = other.streams_.begin();
+    auto fit = other.files_.begin();
+
+    for (auto& i : other.items_) {
+        switch (i) {
+            case data_item::stream:
+            items_.emplace_back(data_item::stream);
+            streams_.emplace_back(
+                std::make_unique<stream_type>(
+                    (*sit)->str(),
+                    std::ios_base::out | std::ios_base::ate
+                )
+            );
+            ++sit;
+            break;
+            case data_item::file:
+            make_file(*fit); ++fit;
+            break;
+        }
+    }
+
+    size_ += other.size_;
+
+    return *this;
+}
+
+data&
+data::operator<<(data&& other)
+{
+    auto sit = other.streams_.begin();
+    auto fit = other.files_.begin();
+
+    for (auto& i : other.items_) {
+        switch (i) {
+            case data_item::stream:
+            items_.emplace_back(data_item::stream);
+            streams_.emplace_back(std::move(*sit));
+            ++sit;
+            break;
+            case data_item::file:
+            make_file(*fit); ++fit;
+            break;
+        }
+    }
+
+    size_ += other.size_;
+    other.clear();
+
+    return *this;
+}
+
 data::stream_type&
 data::make_stream()
 {
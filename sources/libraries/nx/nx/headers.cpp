@@ -1,3 +1,5 @@
+#include <cctype>
+
 #include <nx/headers.hpp>
 #include <nx/escape.hpp>
 
@@ -13,4 +15,47 @@ headers::operator()(std::ostream& os) const
     return os;
 }
 
+header_views::header_views(const phr_header* h, std::size_t count)
+: h_(h),
+count_(count)
+{}
+
+bool
+header_views::has(string_ref name) const
+{ return find(name) != nullptr; }
+
+string_ref
+header_views::operator[](string_ref name) const
+{
+    auto h = find(name);
+
+    return h ? value_of(*h) : string_ref();
+}
+
+const phr_header*
+header_views::find(string_ref name) const
+{
+    for (auto& h : *this) {
+        // Continuation lines have no name
+        if (h.name == nullptr || h.name_len != name.size()) {
+            continue;
+        }
+
+        bool same = true;
+
+        for (std::size_t i = 0; same && i < name.size(); i++) {
+            same =
+                std::tolower((unsigned char) h.name[i])
+                ==
+                std::tolower((unsigned char) name[i]);
+        }
+
+        if (same) {
+            return &h;
+        }
+    }
+
+    return nullptr;
+}
+
 } // namespace nx
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <cctype>
+#include <cstring>
 #include <algorithm>
 
 #include <nx/http_msg.hpp>
@@ -20,8 +21,9 @@ http_msg_base::~http_msg_base()
 http_msg_base&
 http_msg_base::operator=(http_msg_base&& other)
 {
-    raw_headers_ptr_ = std::move(other.raw_headers_ptr_);
-    headers_ = std::move(other.headers_);
+    // Parsed headers view the other message's arena
+    headers_ = other.all_headers();
+    parsed_ = header_views();
     content_length_ = other.content_length_;
     data_ = std::move(other.data_);
 
@@ -32,34 +34,77 @@ http_msg_base::operator=(http_msg_base&& other)
     return *this;
 }
 
+void
+http_msg_base::clear()
+{
+    // Containers must leave the arena before it is reset
+    headers_ = headers(arena_);
+    parsed_ = header_views();
+    raw_headers_ = nullptr;
+    arena_.reset();
+
+    content_length_ = 0;
+    data_.clear();
+    minor_version_ = 1;
+    num_headers_ = 0;
+    prev_buf_len_ = 0;
+}
+
 void
 http_msg_base::pre_parse()
 {
     num_headers_ = max_headers;
 
-    if (!raw_headers_ptr_) {
-        raw_headers_ptr_ = std::make_unique<phr_header[]>(max_headers);
+    if (!raw_headers_) {
+        raw_headers_ = arena_.make_array<phr_header>(max_headers);
     }
 }
 
 void
-http_msg_base::post_parse()
+http_msg_base::post_parse(const char* head, std::size_t size)
 {
+    // The receive buffer moves on, keep a single copy of the head
+    auto copy = static_cast<char*>(arena_.allocate(size, 1));
+    std::memcpy(copy, head, size);
+
     for (std::size_t i = 0; i < num_headers_; i++) {
-        auto& h = raw_headers_ptr_.get()[i];
+        auto& h = raw_headers_[i];
 
-        std::string name(h.name, h.name_len);
-        std::string value(h.value, h.value_len);
+        if (h.name) {
+            h.name = copy + (h.name - head);
+        }
 
-        headers_ << header(std::move(name), std::move(value));
+        h.value = copy + (h.value - head);
     }
 
+    parsed_ = header_views(raw_headers_, num_headers_);
+
     // Grab common useful header values
-    if (headers_.has(nx::content_length)) {
-        content_length_ = to_num<std::size_t>(headers_[nx::content_length]);
+    auto cl = parsed_[nx::content_length];
+
+    if (!cl.empty()) {
+        content_length_ = to_num<std::size_t>(cl.to_string());
     }
+}
+
+bool
+http_msg_base::parse(buffer& b)
+{
+    auto consumed = parse(b.data(), b.size());
+
+    b.erase(b.begin(), b.begin() + consumed);
+
+    return consumed > 0;
+}
+
+bool
+http_msg_base::parse(recv_buffer& b)
+{
+    auto consumed = parse(b.data(), b.size());
+
+    b.consume(consumed);
 
-    raw_headers_ptr_.reset();
+    return consumed > 0;
 }
 
 std::size_t
@@ -72,24 +117,127 @@ http_msg_base::data() const
 
 std::string&
 http_msg_base::h(const std::string& name)
-{ return headers_[name]; }
+{
+    materialize(name);
+
+    return headers_[name];
+}
 
 const std::string&
 http_msg_base::h(const std::string& name) const
-{ return headers_[name]; }
+{
+    materialize(name);
+
+    // Missing headers read as empty
+    const auto& hdrs = headers_;
+
+    return hdrs[name];
+}
+
+string_ref
+http_msg_base::hv(string_ref name) const
+{
+    if (!headers_.empty()) {
+        auto n = name.to_string();
+
+        if (headers_.has(n)) {
+            return headers_[n];
+        }
+    }
+
+    return parsed_[name];
+}
 
 bool
 http_msg_base::has(const header& h) const
-{ return headers_.has(h.name) && headers_[h.name] == h.value; }
+{
+    if (headers_.has(h.name)) {
+        return headers_[h.name] == h.value;
+    }
+
+    return parsed_[h.name] == h.value;
+}
 
 bool
 http_msg_base::has(const std::string& name) const
-{ return headers_.has(name); }
+{ return headers_.has(name) || parsed_.has(name); }
+
+headers
+http_msg_base::all_headers() const
+{
+    headers hdrs = headers_;
+
+    for (const auto& p : parsed_) {
+        if (p.name && !headers_.has(name_of(p).to_string())) {
+            hdrs << header(name_of(p).to_string(), value_of(p).to_string());
+        }
+    }
+
+    return hdrs;
+}
+
+std::string
+http_msg_base::header_data() const
+{
+    buffer b;
+
+    write_head(b);
+
+    return std::string(b.begin(), b.end());
+}
+
+void
+http_msg_base::write_headers(buffer& b) const
+{
+    for (const auto& p : headers_) {
+        b << p.first << ": " << p.second << "\r\n";
+    }
+
+    for (const auto& p : parsed_) {
+        if (!p.name) {
+            continue;
+        }
+
+        auto name = name_of(p);
+
+        if (!headers_.empty() && headers_.has(name.to_string())) {
+            continue;
+        }
+
+        b << name << ": " << value_of(p) << "\r\n";
+    }
+}
+
+void
+http_msg_base::write_size(buffer& b, std::size_t n)
+{
+    char digits[20];
+    char* p = digits + sizeof(digits);
+
+    do {
+        *--p = '0' + n % 10;
+        n /= 10;
+    } while (n);
+
+    b.insert(b.end(), p, digits + sizeof(digits));
+}
+
+void
+http_msg_base::materialize(const std::string& name) const
+{
+    if (headers_.has(name)) {
+        return;
+    }
+
+    if (auto p = parsed_.find(name)) {
+        headers_ << header(name_of(*p).to_string(), value_of(*p).to_string());
+    }
+}
 
 http_msg_base&
 http_msg_base::operator<<(const header& h)
 {
-    headers_ << h;
+    headers_.replace(h);
 
     return *this;
 }
@@ -1,4 +1,5 @@
 #include <sstream>
+#include <array>
 
 #include <nx/http_status.hpp>
 
@@ -63,4 +64,55 @@ bool
 http_status::is_error() const
 { return !error.empty(); }
 
+namespace {
+
+const std::size_t status_line_prefix = 13; // "HTTP/1.1 200 "
+
+using status_lines = std::array<std::string, 600>;
+
+status_lines
+make_status_lines()
+{
+    status_lines lines;
+
+    for (const auto& s : {
+        SwitchingProtocols,
+        OK, Created, Accepted, NonAuthoritativeInformation,
+        NoContent, ResetContent, PartialContent,
+        BadRequest, Forbidden, NotFound, MethodNotAllowed, Locked,
+        InternalServerError
+    }) {
+        lines[s.code] =
+            "HTTP/1.1 " + std::to_string(s.code) + " " + s.status + "\r\n";
+    }
+
+    return lines;
+}
+
+} // namespace
+
+const std::string&
+status_line(const http_status& s)
+{
+    static const status_lines lines = make_status_lines();
+    static const std::string none;
+
+    if (s.code >= lines.size()) {
+        return none;
+    }
+
+    const auto& line = lines[s.code];
+
+    // Custom status texts are rendered by the caller
+    if (
+        line.size() != status_line_prefix + s.status.size() + 2
+        ||
+        line.compare(status_line_prefix, s.status.size(), s.status) != 0
+    ) {
+        return none;
+    }
+
+    return line;
+}
+
 } // namespace nx
@@ -5,7 +5,8 @@ namespace nx {
 http_request::http_request(const method& m, const endpoint& ep, int32_t timeout)
 : timeout_(timeout),
   req_(m),
-  ep_(ep)
+  ep_(ep),
+  options_(http_socket_options())
 {}
 
 http_request::http_request(http_request&& other)
@@ -21,6 +22,7 @@ http_request::operator=(http_request&& other)
     req_ = std::move(other.req_);
     ep_ = std::move(other.ep_);
     reply_cb_ = std::move(other.reply_cb_);
+    options_ = other.options_;
 
     return *this;
 }
@@ -32,6 +34,13 @@ http_request::operator/(const std::string& path)
     return *this;
 }
 
+http_request&
+http_request::operator<<(const socket_options& o)
+{
+    options_ = o;
+    return *this;
+}
+
 http_request&
 http_request::operator=(reply_cb cb)
 {
@@ -47,17 +56,17 @@ http_request::start()
     if (ep_.ep_protocol == endpoint::protocol::TCP)
     {
         if (timeout_ >= 0) { 
-            sync_connect<http_tcp>(ep_.ep_tcp, std::move(req_), std::move(reply_cb_), timeout_);
+            sync_connect<http_tcp>(ep_.ep_tcp, std::move(req_), std::move(reply_cb_), timeout_, options_);
         }   else {
-            async_connect<http_tcp>(ep_.ep_tcp, std::move(req_), std::move(reply_cb_));
+            async_connect<http_tcp>(ep_.ep_tcp, std::move(req_), std::move(reply_cb_), options_);
         }
     }
     else
     {
         if (timeout_ >= 0) { 
-            sync_connect<http_local>(ep_.ep_local, std::move(req_), std::move(reply_cb_), timeout_);
+            sync_connect<http_local>(ep_.ep_local, std::move(req_), std::move(reply_cb_), timeout_, options_);
         }   else {
-            async_connect<http_local>(ep_.ep_local, std::move(req_), std::move(reply_cb_));
+            async_connect<http_local>(ep_.ep_local, std::move(req_), std::move(reply_cb_), options_);
         }
     }
 }
@@ -4,26 +4,28 @@
 
 namespace nx {
 
-route&
-httpd::operator()(const method& m)
+httpd::httpd()
 {
-    auto& r = routes_map_[m.str];
+    *this << http_socket_options();
 
-    r.emplace_back();
+    auto cb = [this](request& req) { return body_route(req); };
 
-    return r.back();
+    s_ << body_route_cb(cb);
+    local_s_ << body_route_cb(cb);
 }
 
+route&
+httpd::operator()(const method& m)
+{ return add_route(m); }
+
 route&
 httpd::operator()(const ws_tag& t)
 {
-    auto& r = routes_map_["GET"];
-
-    r.emplace_back();
-
-    r.back() = [](const request& req, buffer& data, reply& rep) {};
-
-    return r.back();
+    return
+        add_route(
+            GET,
+            [](const request& req, buffer& data, reply& rep) {}
+        );
 }
 
 endpoint
@@ -45,6 +47,9 @@ httpd::operator()(const endpoint& ep)
 endpoint_tcp
 httpd::operator()(const endpoint_tcp& ep)
 {
+    // Report duplicate routes before serving
+    current_router();
+
     return
         serve(
             s_,
@@ -58,6 +63,9 @@ httpd::operator()(const endpoint_tcp& ep)
 endpoint_local
 httpd::operator()(const endpoint_local& ep)
 {
+    // Report duplicate routes before serving
+    current_router();
+
     return
         serve(
             local_s_,
@@ -68,6 +76,24 @@ httpd::operator()(const endpoint_local& ep)
         );
 }
 
+httpd&
+httpd::operator<<(const socket_options& o)
+{
+    s_.options(o);
+    local_s_.options(o);
+
+    return *this;
+}
+
+httpd&
+httpd::operator<<(const http_keep_alive& k)
+{
+    s_.keep_alive(k);
+    local_s_.keep_alive(k);
+
+    return *this;
+}
+
 httpd&
 httpd::operator<<(json_collection_base& c)
 {
@@ -92,39 +118,125 @@ httpd::operator<<(json_collection_base& c)
 void
 httpd::operator()(request& req, buffer& data, reply& rep)
 {
-    auto it = routes_map_.find(req.method());
+    auto r = current_router();
+    auto rt = r->find(req);
 
-    if (it == routes_map_.end()) {
-        // No handlers declared for this method
+    if (!rt) {
         throw NotFound;
     }
 
-    auto& routes = it->second;
-    bool matched = false;
-    std::vector<std::string> matches;
+    (*rt)(req, data, rep);
+}
 
-    for (const auto& r : routes) {
-        if (r.match(req)) {
-            matches.emplace_back(r.path());
+request_handlers
+httpd::body_route(request& req)
+{
+    request_handlers h;
 
-            if (!matched) {
-                matched = true;
-                r(req, data, rep);
-            }
-        }
+    // Routes outlive the routers compiled from them
+    auto rt = current_router()->find(req);
+
+    if (!rt) {
+        h.on_request = [](request& req, buffer& data, reply& rep) {
+            throw NotFound;
+        };
+
+        return h;
     }
 
-    if (!matched) {
-        throw NotFound;
-    } else if (matches.size() > 1) {
-        std::cerr
-            << "WHOAA: more than one route matched: " << req.path() << "\n"
-            ;
+    h.on_request = [rt](request& req, buffer& data, reply& rep) {
+        (*rt)(req, data, rep);
+    };
 
-        for (const auto& m : matches) {
-            std::cerr << m << std::endl;
+    if (rt->streams_body()) {
+        h.on_body = [rt](request& req, buffer& chunk, reply& rep) {
+            rt->body(req, chunk, rep);
+        };
+    }
+
+    return h;
+}
+
+route&
+httpd::add_route(const method& m, route_cb cb)
+{
+    std::lock_guard<std::mutex> lock(router_mutex_);
+
+    all_routes_.emplace_back();
+
+    auto& rt = all_routes_.back();
+    auto& r = method_routes(m);
+
+    if (cb) {
+        // Default handler, the route isn't complete yet
+        rt = cb;
+    }
+
+    // Compiled on next lookup once complete, never while its path is
+    // still being built. Bad paths are reported to whoever completes the
+    // route, they never reach the router
+    rt.on_ready([this, &rt, &r]() {
+        router::check(rt.path());
+
+        std::lock_guard<std::mutex> lock(router_mutex_);
+
+        r.push_back(&rt);
+        dirty_ = true;
+    });
+
+    return rt;
+}
+
+std::vector<const route*>&
+httpd::method_routes(const method& m)
+{
+    auto v = m.id != verb::other ? m.id : verb_of(m.str);
+
+    if (v != verb::other) {
+        return routes_[static_cast<std::size_t>(v)];
+    }
+
+    return other_routes_[m.str];
+}
+
+std::shared_ptr<const router>
+httpd::current_router()
+{
+    if (dirty_) {
+        std::lock_guard<std::mutex> lock(router_mutex_);
+
+        if (dirty_) {
+            auto r = std::make_shared<router>();
+            auto report = [](const std::string& m, const route& rt, const route* other) {
+                if (other) {
+                    std::cerr
+                        << "duplicate route ignored: "
+                        << m << " " << rt.path()
+                        << " (same as " << other->path() << ")"
+                        << std::endl;
+                }
+            };
+
+            for (std::size_t i = 0; i < verb_count; i++) {
+                auto v = static_cast<verb>(i);
+
+                for (auto rt : routes_[i]) {
+                    report(verb_name(v), *rt, r->add(v, *rt));
+                }
+            }
+
+            for (const auto& p : other_routes_) {
+                for (auto rt : p.second) {
+                    report(p.first, *rt, r->add(p.first, *rt));
+                }
+            }
+
+            std::atomic_store(&router_, std::shared_ptr<const router>(r));
+            dirty_ = false;
         }
     }
+
+    return std::atomic_load(&router_);
 }
 
 } // namespace nx
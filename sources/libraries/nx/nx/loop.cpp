@@ -0,0 +1,41 @@
+#include <nx/loop.hpp>
+
+namespace nx {
+
+namespace {
+
+thread_local asio::io_service* current_io_ = nullptr;
+
+} // namespace
+
+void
+run_loop(asio::io_service& io)
+{
+    auto prev = current_io_;
+
+    current_io_ = &io;
+    io.run();
+    current_io_ = prev;
+}
+
+std::size_t
+poll_loop(asio::io_service& io, boost::system::error_code& ec)
+{
+    auto prev = current_io_;
+
+    current_io_ = &io;
+    auto count = io.poll(ec);
+    current_io_ = prev;
+
+    return count;
+}
+
+bool
+in_loop(const asio::io_service& io)
+{ return current_io_ == &io; }
+
+asio::io_service*
+current_loop()
+{ return current_io_; }
+
+} // namespace nx
@@ -0,0 +1,73 @@
+#include <cstring>
+
+#include <nx/methods.hpp>
+
+namespace nx {
+
+namespace {
+
+inline bool
+is(const char* name, const char* v, std::size_t len)
+{ return std::memcmp(name, v, len) == 0; }
+
+} // namespace
+
+verb
+verb_of(const char* name, std::size_t len)
+{
+    // Methods are case-sensitive
+    switch (len) {
+        case 3:
+        if (is(name, "GET", 3)) {
+            return verb::get;
+        } else if (is(name, "PUT", 3)) {
+            return verb::put;
+        }
+        break;
+        case 4:
+        if (is(name, "POST", 4)) {
+            return verb::post;
+        } else if (is(name, "HEAD", 4)) {
+            return verb::head;
+        }
+        break;
+        case 5:
+        if (is(name, "PATCH", 5)) {
+            return verb::patch;
+        } else if (is(name, "TRACE", 5)) {
+            return verb::trace;
+        }
+        break;
+        case 6:
+        if (is(name, "DELETE", 6)) {
+            return verb::delete_;
+        }
+        break;
+        case 7:
+        if (is(name, "OPTIONS", 7)) {
+            return verb::options;
+        } else if (is(name, "CONNECT", 7)) {
+            return verb::connect;
+        }
+        break;
+    }
+
+    return verb::other;
+}
+
+verb
+verb_of(const std::string& name)
+{ return verb_of(name.data(), name.size()); }
+
+const char*
+verb_name(verb v)
+{
+    static const char* names[verb_count + 1] = {
+        "GET", "HEAD", "POST", "PUT", "DELETE",
+        "CONNECT", "OPTIONS", "TRACE", "PATCH", ""
+    };
+
+    return names[static_cast<std::size_t>(v)];
+}
+
+} // namespace nx
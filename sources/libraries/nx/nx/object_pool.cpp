@@ -0,0 +1,121 @@
+#include <atomic>
+#include <map>
+
+#include <nx/object_pool.hpp>
+
+namespace nx {
+
+constexpr std::size_t object_pool::default_max_free;
+
+namespace {
+
+std::atomic<std::size_t> max_free_{ object_pool::default_max_free };
+
+struct pools
+{
+    std::mutex m;
+    std::map<std::size_t, object_pool*> by_size;
+};
+
+pools&
+all_pools()
+{
+    // Never destroyed, objects may be released during static destruction
+    static auto p = new pools();
+    return *p;
+}
+
+} // namespace
+
+object_pool&
+object_pool::get(std::size_t size)
+{
+    auto& all = all_pools();
+    std::lock_guard<std::mutex> lock(all.m);
+
+    auto& p = all.by_size[size];
+
+    if (!p) {
+        p = new object_pool(size);
+    }
+
+    return *p;
+}
+
+void
+object_pool::set_max_free(std::size_t count)
+{ max_free_ = count; }
+
+std::size_t
+object_pool::max_free()
+{ return max_free_; }
+
+void
+object_pool::trim_all()
+{
+    auto& all = all_pools();
+    std::lock_guard<std::mutex> lock(all.m);
+
+    for (auto& p : all.by_size) {
+        p.second->trim();
+    }
+}
+
+object_pool::object_pool(std::size_t size)
+: size_(size)
+{}
+
+void*
+object_pool::acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_);
+
+        if (!free_.empty()) {
+            auto p = free_.back();
+            free_.pop_back();
+            return p;
+        }
+    }
+
+    return ::operator new(size_);
+}
+
+void
+object_pool::release(void* p)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_);
+
+        if (free_.size() < max_free_) {
+            free_.push_back(p);
+            return;
+        }
+    }
+
+    ::operator delete(p);
+}
+
+void
+object_pool::trim()
+{
+    std::vector<void*> blocks;
+
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        blocks.swap(free_);
+    }
+
+    for (auto p : blocks) {
+        ::operator delete(p);
+    }
+}
+
+std::size_t
+object_pool::size()
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return free_.size();
+}
+
+} // namespace nx
@@ -0,0 +1,108 @@
+#include <cstdint>
+
+#include <nx/object_registry.hpp>
+
+namespace nx {
+
+object_registry::~object_registry()
+{ clear(); }
+
+void
+object_registry::add(object_ptr sptr)
+{
+    auto o = sptr.get();
+    auto& s = shard_of(o);
+    std::lock_guard<std::mutex> lock(s.m);
+
+    if (o->registered_) {
+        return;
+    }
+
+    o->registered_ = std::move(sptr);
+    o->prev_ = nullptr;
+    o->next_ = s.head;
+
+    if (s.head) {
+        s.head->prev_ = o;
+    }
+
+    s.head = o;
+}
+
+void
+object_registry::remove(const object_ptr& sptr)
+{
+    auto o = sptr.get();
+    auto& s = shard_of(o);
+    object_ptr last;
+
+    {
+        std::lock_guard<std::mutex> lock(s.m);
+
+        if (!o->registered_) {
+            return;
+        }
+
+        if (o->prev_) {
+            o->prev_->next_ = o->next_;
+        } else {
+            s.head = o->next_;
+        }
+
+        if (o->next_) {
+            o->next_->prev_ = o->prev_;
+        }
+
+        o->prev_ = nullptr;
+        o->next_ = nullptr;
+        last = std::move(o->registered_);
+    }
+
+    // Object may be destroyed here, outside of the shard lock
+}
+
+std::vector<object_ptr>
+object_registry::objects()
+{
+    std::vector<object_ptr> result;
+
+    for (auto& s : shards_) {
+        std::lock_guard<std::mutex> lock(s.m);
+
+        for (auto o = s.head; o; o = o->next_) {
+            result.emplace_back(o->registered_);
+        }
+    }
+
+    return result;
+}
+
+void
+object_registry::clear()
+{
+    std::vector<object_ptr> released;
+
+    for (auto& s : shards_) {
+        std::lock_guard<std::mutex> lock(s.m);
+
+        while (auto o = s.head) {
+            s.head = o->next_;
+            o->prev_ = nullptr;
+            o->next_ = nullptr;
+            released.emplace_back(std::move(o->registered_));
+        }
+    }
+
+    // Objects are destroyed when released goes out of scope
+}
+
+object_registry::shard&
+object_registry::shard_of(const object_base* o)
+{
+    // Objects are heap allocated, low bits carry little entropy
+    auto h = reinterpret_cast<std::uintptr_t>(o) >> 6;
+
+    return shards_[h % shard_count];
+}
+
+} // namespace nx
@@ -0,0 +1,85 @@
+#include <cstring>
+#include <algorithm>
+
+#include <nx/recv_buffer.hpp>
+#include <nx/buffer_pool.hpp>
+
+namespace nx {
+
+recv_buffer::recv_buffer(recv_buffer&& other)
+{ *this = std::move(other); }
+
+recv_buffer::~recv_buffer()
+{ release(); }
+
+recv_buffer&
+recv_buffer::operator=(recv_buffer&& other)
+{
+    release();
+
+    storage_.swap(other.storage_);
+    rpos_ = other.rpos_;
+    wpos_ = other.wpos_;
+
+    other.rpos_ = 0;
+    other.wpos_ = 0;
+
+    return *this;
+}
+
+void
+recv_buffer::consume(std::size_t n)
+{ rpos_ = std::min(rpos_ + n, wpos_); }
+
+void
+recv_buffer::clear()
+{ rpos_ = wpos_; }
+
+char*
+recv_buffer::prepare(std::size_t n)
+{
+    if (rpos_ == wpos_) {
+        // Everything was read, start over at the front
+        rpos_ = 0;
+        wpos_ = 0;
+    }
+
+    if (storage_.size() - wpos_ >= n) {
+        return storage_.data() + wpos_;
+    }
+
+    auto pending = size();
+
+    if (storage_.size() - pending >= n) {
+        // Enough room once unread data is moved to the front
+        std::memmove(storage_.data(), data(), pending);
+    } else {
+        auto& pool = buffer_pool::get();
+        auto b = pool.acquire_raw(pending + n);
+
+        // Raw storage, resizing leaves bytes as they are
+        b.resize(b.capacity());
+        std::memcpy(b.data(), data(), pending);
+        pool.release(storage_);
+        storage_.swap(b);
+    }
+
+    rpos_ = 0;
+    wpos_ = pending;
+
+    return storage_.data() + wpos_;
+}
+
+void
+recv_buffer::commit(std::size_t n)
+{ wpos_ += n; }
+
+void
+recv_buffer::release()
+{
+    buffer_pool::get().release(storage_);
+    rpos_ = 0;
+    wpos_ = 0;
+}
+
+} // namespace nx
@@ -27,7 +27,11 @@ reply::operator=(reply&& other)
 
     postponed_ = other.postponed_;
     upgraded_ = other.upgraded_;
+    streaming_ = other.streaming_;
+    chunked_ = other.chunked_;
     done_cbs_ = std::move(other.done_cbs_);
+    stream_cb_ = std::move(other.stream_cb_);
+    body_flow_cb_ = std::move(other.body_flow_cb_);
 
     minor_version_ = other.minor_version_;
     raw_status_ = other.raw_status_;
@@ -41,37 +45,36 @@ reply::operator=(reply&& other)
 reply::operator bool() const
 { return status_.code == 200; }
 
-bool
-reply::parse(buffer& b)
+std::size_t
+reply::parse(const char* data, std::size_t size)
 {
-    bool parsed = false;
+    std::size_t consumed = 0;
 
     pre_parse();
 
     int ret = phr_parse_response(
-        b.data(), b.size(),
+        data, size,
         &minor_version_,
         &raw_status_,
         &raw_msg_, &raw_msg_len_,
-        raw_headers_ptr_.get(), &num_headers_,
+        raw_headers_, &num_headers_,
         prev_buf_len_
     );
 
     if (ret > 0) {
-        parsed = true;
+        consumed = (std::size_t) ret;
         status_.code = raw_status_;
         status_.status.assign(raw_msg_, raw_msg_len_);
-        post_parse();
-        b.erase(b.begin(), b.begin() + (std::size_t) ret);
+        post_parse(data, consumed);
     } else if (ret == -1) {
         throw BadResponse;
     } else if (ret != -2) {
         throw InternalClientError;
     }
 
-    prev_buf_len_ = b.size();
+    prev_buf_len_ = size - consumed;
 
-    return parsed;
+    return consumed;
 }
 
 const http_status&
@@ -86,23 +89,42 @@ bool
 reply::is_error() const
 { return status_.is_error(); }
 
-std::string
-reply::header_data() const
+void
+reply::write_head(buffer& b) const
 {
-    std::ostringstream oss;
+    const auto& line = status_line(status_);
+
+    if (!line.empty()) {
+        b << line;
+    } else {
+        b << "HTTP/1.1 ";
+        write_size(b, status_.code);
+        b << " " << status_.status << "\r\n";
+    }
 
-    auto hdrs = headers_;
+    write_headers(b);
 
-    hdrs << header(nx::Content_Length, std::to_string(data_.size()));
+    if (!streaming_) {
+        if (!has(nx::content_length)) {
+            b << "Content-Length: ";
+            write_size(b, data_.size());
+            b << "\r\n";
+        }
+    } else if (chunked_ && !has(nx::transfer_encoding)) {
+        b << "Transfer-Encoding: chunked\r\n";
+    }
 
-    oss
-        << "HTTP/1.1 "
-        << status_.code << " " << status_.status << "\r\n"
-        << hdrs
-        << "\r\n"
-        ;
+    b << "\r\n";
+}
 
-    return oss.str();
+bool
+reply::closes_connection() const
+{
+    return
+        has(connection)
+        &&
+        lc(hv(connection).to_string()).find("close") != std::string::npos
+        ;
 }
 
 void
@@ -116,9 +138,29 @@ reply::postponed()
 void
 reply::done()
 {
-    while (!done_cbs_.empty()) {
-        auto cb = std::move(done_cbs_.back());
-        done_cbs_.pop_back();
+    if (streaming_) {
+        flush();
+
+        if (chunked_) {
+            // Last chunk
+            nx::data d;
+            d << "0\r\n\r\n";
+            send(std::move(d));
+        }
+    }
+
+    // Servers hand hooks holding their connection
+    stream_cb_ = nullptr;
+    body_flow_cb_ = nullptr;
+
+    // The last callback may recycle the reply, don't touch it afterwards
+    void_cbs cbs;
+
+    cbs.swap(done_cbs_);
+
+    while (!cbs.empty()) {
+        auto cb = std::move(cbs.back());
+        cbs.pop_back();
 
         try {
             cb();
@@ -131,6 +173,112 @@ reply::done()
     }
 }
 
+void
+reply::stream()
+{
+    if (streaming_) {
+        return;
+    }
+
+    postponed_ = true;
+    streaming_ = true;
+
+    if (!chunked_) {
+        // Body ends with the connection
+        *this << connection_close;
+    }
+
+    nx::data d;
+    d << header_data();
+    send(std::move(d));
+
+    flush();
+}
+
+bool
+reply::streaming() const
+{ return streaming_; }
+
+bool
+reply::chunked() const
+{ return chunked_; }
+
+reply&
+reply::flush()
+{
+    if (!streaming_ || !stream_cb_ || data_.size() == 0) {
+        return *this;
+    }
+
+    nx::data d;
+
+    if (chunked_) {
+        std::ostringstream size;
+        size << std::hex << data_.size() << "\r\n";
+
+        d << size.str() << std::move(data_) << "\r\n";
+    } else {
+        d << std::move(data_);
+    }
+
+    data_.clear();
+    send(std::move(d));
+
+    return *this;
+}
+
+void
+reply::on_stream(stream_cb cb, bool chunked)
+{
+    stream_cb_ = std::move(cb);
+    chunked_ = chunked;
+}
+
+void
+reply::pause_body()
+{
+    if (body_flow_cb_) {
+        body_flow_cb_(true);
+    }
+}
+
+void
+reply::resume_body()
+{
+    if (body_flow_cb_) {
+        body_flow_cb_(false);
+    }
+}
+
+void
+reply::on_body_flow(body_flow_cb cb)
+{ body_flow_cb_ = std::move(cb); }
+
+void
+reply::send(nx::data&& d)
+{
+    if (stream_cb_) {
+        stream_cb_(std::move(d));
+    }
+}
+
+void
+reply::clear()
+{
+    status_ = OK;
+    postponed_ = false;
+    upgraded_ = false;
+    streaming_ = false;
+    chunked_ = true;
+    done_cbs_.clear();
+    stream_cb_ = nullptr;
+    body_flow_cb_ = nullptr;
+    ws_connection_ = ws_connection();
+    prev_buf_len_ = 0;
+
+    http_msg::clear();
+}
+
 bool
 reply::operator==(const http_status& s) const
 { return status_ == s; }
@@ -142,7 +290,7 @@ reply::operator!=(const http_status& s) const
 reply&
 reply::operator|(void_cb cb)
 {
-    done_cbs_.emplace_back(cb);
+    done_cbs_.emplace_back(std::move(cb));
 
     return *this;
 }
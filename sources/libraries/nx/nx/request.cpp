@@ -13,18 +13,19 @@ request::request()
 {}
 
 request::request(const nx::method& m)
-: http_msg(),
-method_(m.str)
-{}
+: http_msg()
+{ *this << m; }
 
 request::request(const std::string& method)
 : http_msg(),
-method_(method)
+method_(method),
+verb_(verb_of(method))
 {}
 
 request::request(const std::string& method, const std::string& path)
 : http_msg(),
 method_(method),
+verb_(verb_of(method)),
 path_(path)
 {}
 
@@ -39,9 +40,14 @@ request::operator=(request&& other)
 {
     http_msg::operator=(std::forward<request>(other));
     method_ = std::move(other.method_);
+    verb_ = other.verb_;
     path_ = std::move(other.path_);
     attrs_ = std::move(other.attrs_);
 
+    // Captures live in the other arena and view its path
+    captures_ = nullptr;
+    capture_count_ = 0;
+
     raw_method_= other.raw_method_;
     raw_method_len_= other.raw_method_len_;
     raw_path_= other.raw_path_;
@@ -50,68 +56,67 @@ request::operator=(request&& other)
     return *this;
 }
 
-bool
-request::parse(buffer& b)
+std::size_t
+request::parse(const char* data, std::size_t size)
 {
-    bool parsed = false;
+    std::size_t consumed = 0;
 
     pre_parse();
 
     int ret = phr_parse_request(
-        b.data(), b.size(),
+        data, size,
         &raw_method_, &raw_method_len_,
         &raw_path_, &raw_path_len_,
         &minor_version_,
-        raw_headers_ptr_.get(), &num_headers_,
+        raw_headers_, &num_headers_,
         prev_buf_len_
     );
 
     if (ret > 0) {
-        parsed = true;
+        consumed = (std::size_t) ret;
         method_.assign(raw_method_, raw_method_len_);
+        verb_ = verb_of(raw_method_, raw_method_len_);
 
         uri u(std::string(raw_path_, raw_path_len_));
         path_ = std::move(u.path());
         attrs_ = std::move(u.a());
 
-        post_parse();
-
-        b.erase(b.begin(), b.begin() + (std::size_t) ret);
+        post_parse(data, consumed);
     } else if (ret == -1) {
         throw BadRequest;
     } else if (ret != -2) {
         throw InternalServerError;
     }
 
-    prev_buf_len_ = b.size();
+    prev_buf_len_ = size - consumed;
 
-    return parsed;
+    return consumed;
 }
 
-std::string
-request::header_data() const
+void
+request::write_head(buffer& b) const
 {
-    std::ostringstream oss;
+    b << method_ << " " << clean_path(path_) << " HTTP/1.1\r\n";
 
-    auto hdrs = headers_;
+    write_headers(b);
 
-    if (method_ != GET.str) {
-        hdrs << header(nx::Content_Length, std::to_string(data_.size()));
+    if (verb_ != nx::verb::get && !has(nx::content_length)) {
+        b << "Content-Length: ";
+        write_size(b, data_.size());
+        b << "\r\n";
     }
 
-    oss
-        << method_ << " " << clean_path(path_) << " HTTP/1.1\r\n"
-        << hdrs
-        << "\r\n"
-        ;
-
-    return oss.str();
+    b << "\r\n";
 }
 
 const std::string&
 request::method() const
 { return method_; }
 
+verb
+request::verb() const
+{ return verb_; }
+
 const std::string&
 request::path() const
 { return path_; }
@@ -130,7 +135,13 @@ request::a(const std::string& name) const
 
 bool
 request::operator==(const nx::method& m) const
-{ return method_ == m.str; }
+{
+    if (m.id != nx::verb::other) {
+        return verb_ == m.id;
+    }
+
+    return method_ == m.str;
+}
 
 bool
 request::operator!=(const nx::method& m) const
@@ -149,6 +160,7 @@ request&
 request::operator<<(const nx::method& m)
 {
     method_ = m.str;
+    verb_ = m.id != nx::verb::other ? m.id : verb_of(m.str);
 
     return *this;
 }
@@ -169,13 +181,64 @@ request::operator<<(const attributes& a)
     return *this;
 }
 
+bool
+request::keep_alive() const
+{
+    if (has(connection)) {
+        auto value = lc(hv(connection).to_string());
+
+        if (value.find("close") != std::string::npos) {
+            return false;
+        }
+
+        if (value.find(Keep_Alive) != std::string::npos) {
+            return true;
+        }
+    }
+
+    return minor_version_ >= 1;
+}
+
+int
+request::minor_version() const
+{ return minor_version_; }
+
+void
+request::clear()
+{
+    method_.clear();
+    verb_ = nx::verb::other;
+    path_.clear();
+    attrs_ = attributes(arena_);
+    captures_ = nullptr;
+    capture_count_ = 0;
+
+    http_msg::clear();
+}
+
+string_ref
+request::capture(std::size_t i) const
+{ return i < capture_count_ ? captures_[i] : string_ref(); }
+
+std::size_t
+request::capture_count() const
+{ return capture_count_; }
+
+void
+request::captures(const string_ref* c, std::size_t count)
+{
+    captures_ = arena_.make_array<string_ref>(count);
+    std::uninitialized_copy(c, c + count, captures_);
+    capture_count_ = count;
+}
+
 bool
 request::is_form() const
 {
     return
         *this == POST
         &&
-        h(content_type) == "application/x-www-form-urlencoded"
+        hv(content_type) == "application/x-www-form-urlencoded"
         ;
 }
 
@@ -2,7 +2,6 @@
 
 #include <nx/route.hpp>
 #include <nx/utils.hpp>
-#include <nx/attributes.hpp>
 #include <nx/utils.hpp>
 
 namespace nx {
@@ -31,6 +30,7 @@ route&
 route::operator=(route_cb cb)
 {
     route_cb_ = cb;
+    ready();
 
     return *this;
 }
@@ -40,53 +40,41 @@ route::operator=(ws_connection ct)
 {
     ws_hook_ = true;
     ct_ = ct;
+    ready();
 
     return *this;
 }
 
-const std::string&
-route::path() const
-{ return path_; }
-
-bool
-route::match(request& req) const
+route&
+route::operator=(body_stream bs)
 {
-    auto req_toks = split("/", req.path());
-    auto my_toks = split("/", path_);
+    body_cb_ = bs.on_data;
+    route_cb_ = bs.on_end;
+    ready();
 
-    if (req_toks.size() != my_toks.size()) {
-        return false;
-    }
+    return *this;
+}
 
-    attributes a;
+void
+route::on_ready(void_cb cb)
+{ ready_cb_ = std::move(cb); }
 
-    for (std::size_t i = 0; i < my_toks.size(); i++) {
-        auto& mt = my_toks[i];
-        auto& rt = req_toks[i];
+const std::string&
+route::path() const
+{ return path_; }
 
-        if (mt.empty() || rt.empty()) {
-            if (i == 0) {
-                // Leading '/'
-                continue;
-            } else {
-                // C'mon...
-                return false;
-            }
-        }
+std::size_t
+route::capture_count() const
+{
+    std::size_t count = 0;
 
-        if (mt[0] == ':') {
-            // This is a placeholder
-            mt.erase(0, 1);
-            a << attribute(mt, rt);
-        } else if (rt != mt) {
-            // Path element mismatch
-            return false;
+    for (std::size_t i = 0; i + 1 < path_.size(); i++) {
+        if (path_[i] == '/' && (path_[i + 1] == ':' || path_[i + 1] == '*')) {
+            count++;
         }
     }
 
-    req << a;
-
-    return true;
+    return count;
 }
 
 void
@@ -98,8 +86,23 @@ route::operator()(const request& req, buffer& data, reply& rep) const
     route_cb_(req, data, rep); 
 }
 
+void
+route::body(const request& req, buffer& chunk, reply& rep) const
+{ body_cb_(req, chunk, rep); }
+
 void
 route::clean_path()
 { path_ = nx::clean_path(path_); }
 
+void
+route::ready()
+{
+    if (ready_cb_) {
+        auto cb = std::move(ready_cb_);
+
+        ready_cb_ = nullptr;
+        cb();
+    }
+}
+
 } // namespace nx
@@ -0,0 +1,93 @@
+#include <nx/route_param.hpp>
+
+namespace nx {
+
+namespace {
+
+int
+hex_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+} // namespace
+
+std::string
+uuid::str() const
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string s;
+
+    s.reserve(36);
+
+    for (std::size_t i = 0; i < bytes.size(); i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) {
+            s += '-';
+        }
+
+        s += digits[bytes[i] >> 4];
+        s += digits[bytes[i] & 0xf];
+    }
+
+    return s;
+}
+
+bool
+parse_capture(string_ref s, std::string& v)
+{
+    v.assign(s.begin(), s.end());
+
+    return true;
+}
+
+bool
+parse_capture(string_ref s, string_ref& v)
+{
+    v = s;
+
+    return true;
+}
+
+bool
+parse_capture(string_ref s, uuid& v)
+{
+    // 8-4-4-4-12 hex digits
+    if (s.size() != 36) {
+        return false;
+    }
+
+    std::size_t b = 0;
+
+    for (std::size_t i = 0; i < s.size(); ) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            if (s[i] != '-') {
+                return false;
+            }
+
+            i++;
+            continue;
+        }
+
+        int hi = hex_value(s[i]);
+        int lo = hex_value(s[i + 1]);
+
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+
+        v.bytes[b++] = static_cast<std::uint8_t>(hi << 4 | lo);
+        i += 2;
+    }
+
+    return true;
+}
+
+} // namespace nx
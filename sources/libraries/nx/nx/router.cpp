@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <nx/router.hpp>
+
+namespace nx {
+
+namespace {
+
+template <typename Child>
+bool
+child_less(const Child& c, string_ref segment)
+{ return string_ref(c.first) < segment; }
+
+} // namespace
+
+router::node*
+router::node::child(const std::string& segment)
+{
+    auto it = std::lower_bound(
+        statics.begin(), statics.end(),
+        string_ref(segment),
+        child_less<decltype(statics)::value_type>
+    );
+
+    if (it == statics.end() || it->first != segment) {
+        it = statics.emplace(it, segment, std::make_unique<node>());
+    }
+
+    return it->second.get();
+}
+
+const router::node*
+router::node::child(string_ref segment) const
+{
+    auto it = std::lower_bound(
+        statics.begin(), statics.end(),
+        segment,
+        child_less<decltype(statics)::value_type>
+    );
+
+    if (it == statics.end() || string_ref(it->first) != segment) {
+        return nullptr;
+    }
+
+    return it->second.get();
+}
+
+void
+router::check(const std::string& path)
+{
+    std::size_t captures = 0;
+    std::size_t pos = 0;
+
+    while (pos < path.size()) {
+        auto end = path.find('/', pos);
+
+        if (end == std::string::npos) {
+            end = path.size();
+        }
+
+        auto first = path[pos];
+        auto empty = end == pos;
+
+        pos = end + 1;
+
+        if (empty || (first != ':' && first != '*')) {
+            continue;
+        }
+
+        captures++;
+
+        if (first == '*' && pos < path.size()) {
+            throw std::runtime_error("wildcard must end route path: " + path);
+        }
+    }
+
+    if (captures > max_captures) {
+        throw std::runtime_error("too many captures in route path: " + path);
+    }
+}
+
+const route*
+router::add(const std::string& method, const route& r)
+{
+    auto v = verb_of(method);
+
+    if (v != verb::other) {
+        return add(v, r);
+    }
+
+    return add(other_trees_[method], r);
+}
+
+const route*
+router::add(verb v, const route& r)
+{ return add(trees_[static_cast<std::size_t>(v)], r); }
+
+const route*
+router::add(node& tree, const route& r)
+{
+    auto* n = &tree;
+    const auto& path = r.path();
+    std::vector<std::string> captures;
+    std::unique_ptr<target>* slot = nullptr;
+    std::size_t pos = 0;
+
+    check(path);
+
+    while (pos < path.size()) {
+        auto end = path.find('/', pos);
+
+        if (end == std::string::npos) {
+            end = path.size();
+        }
+
+        auto segment = path.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (segment.empty()) {
+            continue;
+        }
+
+        if (segment[0] == ':') {
+            captures.emplace_back(segment.substr(1));
+
+            if (!n->param) {
+                n->param = std::make_unique<node>();
+            }
+
+            n = n->param.get();
+        } else if (segment[0] == '*') {
+            captures.emplace_back(segment.size() > 1 ? segment.substr(1) : "*");
+            slot = &n->wildcard;
+        } else {
+            n = n->child(segment);
+        }
+    }
+
+    if (!slot) {
+        slot = &n->leaf;
+    }
+
+    if (*slot) {
+        return (*slot)->r;
+    }
+
+    *slot = std::make_unique<target>();
+    (*slot)->r = &r;
+    (*slot)->captures = std::move(captures);
+
+    return nullptr;
+}
+
+const route*
+router::find(request& req) const
+{
+    const node* tree = nullptr;
+
+    if (req.verb() != verb::other) {
+        tree = &trees_[static_cast<std::size_t>(req.verb())];
+    } else {
+        auto it = other_trees_.find(req.method());
+
+        if (it == other_trees_.end()) {
+            return nullptr;
+        }
+
+        tree = &it->second;
+    }
+
+    string_ref path(req.path());
+    match m;
+
+    if (!find(*tree, path, path.starts_with('/') ? 1 : 0, m)) {
+        return nullptr;
+    }
+
+    req.captures(m.captures, m.count);
+
+    if (!m.t->r->typed()) {
+        for (std::size_t i = 0; i < m.count; i++) {
+            req << attribute(m.t->captures[i], m.captures[i].to_string());
+        }
+    }
+
+    return m.t->r;
+}
+
+bool
+router::find(const node& n, string_ref path, std::size_t pos, match& m)
+{
+    if (pos >= path.size()) {
+        if (n.leaf) {
+            m.t = n.leaf.get();
+            return true;
+        }
+
+        return false;
+    }
+
+    auto end = static_cast<std::size_t>(
+        std::find(path.begin() + pos, path.end(), '/') - path.begin()
+    );
+    auto segment = path.substr(pos, end - pos);
+    auto next = end + 1;
+
+    if (segment.empty()) {
+        // Empty segment
+        return false;
+    }
+
+    if (auto c = n.child(segment)) {
+        if (find(*c, path, next, m)) {
+            return true;
+        }
+    }
+
+    if (m.count == max_captures) {
+        return false;
+    }
+
+    if (n.param) {
+        m.captures[m.count++] = segment;
+
+        if (find(*n.param, path, next, m)) {
+            return true;
+        }
+
+        m.count--;
+    }
+
+    if (n.wildcard) {
+        auto rest = path.substr(pos);
+
+        if (rest.ends_with('/')) {
+            rest.remove_suffix(1);
+        }
+
+        m.captures[m.count++] = rest;
+        m.t = n.wildcard.get();
+
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace nx
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <memory>
 
 #include <nx/service.hpp>
@@ -18,47 +19,96 @@ service::get()
     return *_sptr_;
 }
 
+std::atomic<std::size_t> loop_count_{ 1 };
+std::atomic<std::size_t> threads_per_loop_count_{ 1 };
+
+void
+service::set_loop_count(std::size_t count)
+{ loop_count_ = count; }
+
+void
+service::set_threads_per_loop(std::size_t count)
+{ threads_per_loop_count_ = count; }
+
+service::loop::loop()
+: io_service(),
+work(io_service),
+threads()
+{}
+
 service::service()
-: io_service_(),
-work_(io_service_),
-t_()
-{ start(); }
+: loops_(),
+threads_per_loop_(std::max<std::size_t>(threads_per_loop_count_, 1)),
+next_loop_(0)
+{
+    std::size_t count = loop_count_;
+
+    if (count == 0) {
+        count = std::thread::hardware_concurrency();
+    }
+
+    if (count == 0) {
+        count = 1;
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+        loops_.emplace_back(std::make_unique<loop>());
+    }
+
+    start();
+}
 
 service::~service()
 { stop(); }
 
+std::size_t
+service::loop_count() const
+{ return loops_.size(); }
+
+std::size_t
+service::threads_per_loop() const
+{ return threads_per_loop_; }
+
 asio::io_service&
 service::io_service()
-{ return io_service_; }
+{
+    auto io = current_loop();
+
+    return io ? *io : loops_.front()->io_service;
+}
 
 const asio::io_service&
 service::io_service() const
-{ return io_service_; }
-
-void
-service::add(object_ptr sptr)
 {
-    std::lock_guard<std::mutex> lock(objects_mutex_);
+    auto io = current_loop();
 
-    objects_.insert(sptr);
+    return io ? *io : loops_.front()->io_service;
 }
 
-void
-service::remove(object_ptr sptr)
+asio::io_service&
+service::io_service(std::size_t i)
+{ return loops_[i % loops_.size()]->io_service; }
+
+asio::io_service&
+service::next_io_service()
 {
-    std::lock_guard<std::mutex> lock(objects_mutex_);
+    auto i = next_loop_.fetch_add(1, std::memory_order_relaxed);
 
-    objects_.erase(sptr);
+    return loops_[i % loops_.size()]->io_service;
 }
 
+void
+service::add(object_ptr sptr)
+{ objects_.add(std::move(sptr)); }
+
+void
+service::remove(object_ptr sptr)
+{ objects_.remove(sptr); }
+
 service&
 service::operator<<(void_cb&& cb)
 {
-    io_service_.post(
-        [cb = std::move(cb)]() {
-            cb();
-        }
-    );
+    io_service().post(make_posted(std::move(cb)));
 
     return *this;
 }
@@ -66,79 +116,110 @@ service::operator<<(void_cb&& cb)
 void
 service::start()
 {
-    if (t_.joinable()) {
-        // Already running
+    for (auto& l : loops_) {
+        if (!l->threads.empty()) {
+            // Already running
+            continue;
+        }
+
+        auto& io = l->io_service;
+
+        for (std::size_t i = 0; i < threads_per_loop_; i++) {
+            l->threads.emplace_back([&io]() { run_loop(io); });
+        }
+    }
+}
+
+void
+service::stop()
+{
+    bool running = false;
+
+    for (auto& l : loops_) {
+        if (!l->threads.empty()) {
+            running = true;
+            l->io_service.stop();
+        }
+    }
+
+    if (!running) {
         return;
     }
 
-    t_ = std::thread(
-        [this]() {
-            io_service_.run();
-            io_service_.reset();
+    for (auto& l : loops_) {
+        for (auto& t : l->threads) {
+            t.join();
+        }
 
-            {
-                std::lock_guard<std::mutex> lock(objects_mutex_);
+        l->threads.clear();
+        l->io_service.reset();
+    }
 
-                for (auto& o : objects_) {
-                    o->stop();
-                }
-            }
+    shutdown();
 
-            {
-                std::lock_guard<std::mutex> lock(tasks_mutex_);
+    for (auto& l : loops_) {
+        l->io_service.reset();
+    }
+}
 
-                for (auto& t : available_tasks_) {
-                    t->stop();
-                }
+void
+service::shutdown()
+{
+    for (auto& o : objects_.objects()) {
+        o->stop();
+    }
 
-                for (auto& t : runnable_tasks_) {
-                    t->stop();
-                }
-            }
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+
+        for (auto& t : available_tasks_) {
+            t->stop();
+        }
 
-            std::size_t count = 0;
-            const std::size_t max_count = 1000;
+        for (auto& t : runnable_tasks_) {
+            t->stop();
+        }
+    }
+
+    std::size_t count = 0;
+    const std::size_t max_count = 1000;
+    bool active = true;
+
+    while (active) {
+        active = false;
+
+        for (auto& l : loops_) {
             error_code ec;
 
-            while (io_service_.poll(ec) != 0) {
-                if (ec) {
-                    std::cout
-                        << "service poll error: "
-                        << ec.message()
-                        << std::endl;
-                }
-
-                if (++count == max_count) {
-                    std::cout
-                        << "WHOA THERE ! "
-                        << "there are still active objects after "
-                        << max_count << " polls"
-                        << std::endl;
-                }
+            if (poll_loop(l->io_service, ec) != 0) {
+                active = true;
             }
 
-            {
-                std::lock_guard<std::mutex> lock(objects_mutex_);
-
-                objects_.clear();
-                available_tasks_.clear();
-                runnable_tasks_.clear();
+            if (ec) {
+                std::cout
+                    << "service poll error: "
+                    << ec.message()
+                    << std::endl;
             }
         }
-    );
-}
 
-void
-service::stop()
-{
-    if (!t_.joinable()) {
-        // Not running
-        return;
+        if (++count == max_count) {
+            std::cout
+                << "WHOA THERE ! "
+                << "there are still active objects after "
+                << max_count << " polls"
+                << std::endl;
+        }
     }
 
-    io_service_.stop();
-    t_.join();
-    io_service_.reset();
+    objects_.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+
+        available_tasks_.clear();
+        runnable_tasks_.clear();
+    }
 }
 
 task_ptr 
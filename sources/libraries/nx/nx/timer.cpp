@@ -45,7 +45,7 @@ timer::stop()
 timer&
 timer::operator=(timer_cb cb)
 {
-    cb_ = cb;
+    cb_ = std::move(cb);
 
     return *this;
 }
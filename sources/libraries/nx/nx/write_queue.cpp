@@ -0,0 +1,85 @@
+#include <nx/write_queue.hpp>
+
+namespace nx {
+
+write_queue::write_queue()
+: head_(&stub_),
+tail_(&stub_)
+{}
+
+write_queue::~write_queue()
+{
+    while (pop()) {
+    }
+}
+
+void
+write_queue::push(write_item_ptr item)
+{ push(item.release()); }
+
+void
+write_queue::push(write_item* item)
+{
+    item->next.store(nullptr, std::memory_order_relaxed);
+
+    // Ordered with the consumer's empty() check once it goes idle
+    auto prev = head_.exchange(item, std::memory_order_seq_cst);
+
+    prev->next.store(item, std::memory_order_release);
+}
+
+write_item_ptr
+write_queue::pop()
+{
+    auto tail = tail_;
+    auto next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &stub_) {
+        if (!next) {
+            return nullptr;
+        }
+
+        tail_ = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        tail_ = next;
+        return write_item_ptr(tail);
+    }
+
+    if (tail != head_.load(std::memory_order_acquire)) {
+        // A producer is linking a new item
+        return nullptr;
+    }
+
+    // tail is the last item, put the stub back behind it
+    push(&stub_);
+
+    next = tail->next.load(std::memory_order_acquire);
+
+    if (next) {
+        tail_ = next;
+        return write_item_ptr(tail);
+    }
+
+    return nullptr;
+}
+
+bool
+write_queue::empty() const
+{
+    // Popped up to the stub with nothing linked behind it, and no
+    // producer half-way through a push (the stub is pushed back by pop()
+    // too, head_ alone may point to it while items wait)
+    return
+        tail_ == &stub_
+        &&
+        !stub_.next.load(std::memory_order_acquire)
+        &&
+        head_.load(std::memory_order_seq_cst) == &stub_
+        ;
+}
+
+} // namespace nx
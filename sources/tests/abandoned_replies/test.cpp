@@ -0,0 +1,106 @@
+#define BOOST_TEST_MODULE abandoned_replies
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/nx.hpp>
+#include <nx/utils.hpp>
+
+/*
+ * Replies never done, and bodies cut short by the client, don't keep their
+ * connection alive: the connection and its replies go away with the client.
+ */
+
+BOOST_AUTO_TEST_CASE(abandoned_replies)
+{
+    using namespace nx;
+    using namespace nx::tags;
+
+    nx::timer deadline;
+    nx::cond_var cv;
+
+    deadline(5) = [&](nx::timer& t) {
+        t.stop();
+        cv.notify();
+    };
+
+    deadline.start();
+
+    httpd hd;
+
+    std::weak_ptr<int> never_token;
+    std::weak_ptr<int> upload_token;
+    std::atomic_size_t requests{ 0 };
+
+    hd(GET) / "never" = [&](const request& req, buffer& data, reply& rep) {
+        auto token = std::make_shared<int>(0);
+
+        never_token = token;
+        rep.postpone();
+
+        // Released with the reply
+        rep | [token]() {};
+        requests++;
+    };
+
+    hd(POST) / "upload" = body_stream{
+        [&](const request& req, buffer& chunk, reply& rep) {
+            if (upload_token.expired()) {
+                auto token = std::make_shared<int>(0);
+
+                upload_token = token;
+                rep | [token]() {};
+                requests++;
+            }
+        },
+        [&](const request& req, buffer& data, reply& rep) {}
+    };
+
+    auto sep = hd(make_endpoint("127.0.0.1"));
+
+    auto send_and_leave = [&](const std::string& data) {
+        auto c = nx::new_object<nx::tcp>();
+        auto& client = *c;
+
+        client[on_read] = [&](nx::tcp& t) {
+            nx::buffer b;
+            t >> b;
+        };
+
+        nx::connect(
+            client,
+            sep.ep_tcp,
+            [&, data](nx::tcp& t) {
+                t << data;
+
+                nx::after(std::chrono::milliseconds(100)) << [&t]() {
+                    t.stop();
+                };
+            }
+        );
+    };
+
+    send_and_leave("GET /never HTTP/1.1\r\nHost: test\r\n\r\n");
+    send_and_leave(
+        "POST /upload HTTP/1.1\r\nHost: test\r\nContent-Length: 1000\r\n\r\n"
+        + std::string(10, 'x')
+    );
+
+    nx::after(std::chrono::milliseconds(500)) << [&]() {
+        cv.notify();
+    };
+
+    cv.wait();
+    deadline.stop();
+
+    BOOST_CHECK_MESSAGE(requests == 2, "requests handled");
+    BOOST_CHECK_MESSAGE(never_token.expired(), "reply never done released");
+    BOOST_CHECK_MESSAGE(upload_token.expired(), "cut short upload released");
+
+    nx::stop();
+}
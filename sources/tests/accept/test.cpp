@@ -0,0 +1,87 @@
+#define BOOST_TEST_MODULE accept
+
+#include <iostream>
+#include <string>
+#include <atomic>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/nx.hpp>
+
+/*
+ * Connection storm on a server with one acceptor per event loop.
+ */
+
+BOOST_AUTO_TEST_CASE(accept_storm)
+{
+    using namespace nx::tags;
+
+    const std::size_t loops = 4;
+    const std::size_t clients = 200;
+
+    nx::service::set_loop_count(loops);
+
+    nx::timer deadline;
+    nx::cond_var cv;
+
+    deadline(10) = [&](nx::timer& t) {
+        t.stop();
+        cv.notify();
+    };
+
+    deadline.start();
+
+    std::string msg("a message");
+
+    std::atomic_size_t accepted{ 0 };
+    std::atomic_size_t replies{ 0 };
+
+    auto server = nx::new_object<nx::tcp>();
+
+    auto endpoint = nx::serve(
+        *server,
+        nx::make_endpoint_tcp("127.0.0.1", 0),
+        [&](nx::tcp& t) {
+            accepted++;
+        },
+        [&](nx::tcp& t) {
+            std::string str;
+
+            t >> str;
+            t << str;
+        }
+    );
+
+    BOOST_CHECK_MESSAGE(
+        server->acceptor_count() == (nx::tcp::per_loop_acceptors ? loops : 1),
+        "server has one acceptor per event loop"
+    );
+
+    for (std::size_t i = 0; i < clients; i++) {
+        nx::connect<nx::tcp>(
+            endpoint,
+            [&](nx::tcp& t) {
+                t[on_read] = [&](nx::tcp& t) {
+                    std::string str;
+
+                    t >> str;
+
+                    if (str == msg && ++replies == clients) {
+                        deadline.stop();
+                        cv.notify();
+                    }
+
+                    t.stop();
+                };
+
+                t << msg;
+            }
+        );
+    }
+
+    cv.wait();
+    nx::stop();
+
+    BOOST_CHECK_MESSAGE(accepted == clients, "server accepted all clients");
+    BOOST_CHECK_MESSAGE(replies == clients, "all clients got a reply");
+}
@@ -0,0 +1,60 @@
+#define BOOST_TEST_MODULE arena
+
+#include <iostream>
+#include <cstdint>
+#include <string>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/arena.hpp>
+#include <nx/headers.hpp>
+
+BOOST_AUTO_TEST_CASE(arena)
+{
+    nx::arena a;
+
+    auto p1 = a.allocate(3, 1);
+    auto p2 = a.allocate(8, 8);
+
+    BOOST_CHECK_MESSAGE(
+        reinterpret_cast<std::uintptr_t>(p2) % 8 == 0,
+        "allocations are aligned"
+    );
+    BOOST_CHECK_MESSAGE(p2 != p1, "allocations don't overlap");
+
+    auto big = a.allocate(4 * nx::arena::chunk_size);
+
+    BOOST_CHECK_MESSAGE(big != nullptr, "oversized allocation succeeds");
+
+    a.reset();
+
+    auto p3 = a.allocate(3, 1);
+
+    BOOST_CHECK_MESSAGE(p3 == p1, "first chunk is reused after reset");
+}
+
+BOOST_AUTO_TEST_CASE(arena_headers)
+{
+    nx::headers copy;
+    nx::headers moved;
+
+    {
+        nx::arena a;
+        nx::headers h(a);
+
+        h << nx::header{ "Content-Type", "text/plain" };
+
+        BOOST_CHECK_MESSAGE(h.has("content-type"), "arena header is found");
+
+        // Copies and moves leave the arena behind
+        copy = h;
+        moved = std::move(h);
+    }
+
+    BOOST_CHECK_MESSAGE(
+        copy["Content-Type"] == "text/plain"
+        &&
+        moved["content-type"] == "text/plain",
+        "copied and moved headers outlive the arena"
+    );
+}
@@ -0,0 +1,89 @@
+#define BOOST_TEST_MODULE backpressure
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <chrono>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/nx.hpp>
+
+/*
+ * Server stops reading when unconsumed input reaches its high watermark,
+ * then resumes once the application consumed it.
+ */
+
+BOOST_AUTO_TEST_CASE(read_backpressure)
+{
+    using namespace nx::tags;
+
+    const std::size_t high = 64 * 1024;
+    const std::size_t low = 16 * 1024;
+    const std::size_t total = 4 * 1024 * 1024;
+
+    nx::timer deadline;
+    nx::cond_var cv;
+
+    deadline(10) = [&](nx::timer& t) {
+        t.stop();
+        cv.notify();
+    };
+
+    deadline.start();
+
+    std::atomic_bool draining{ false };
+    std::atomic_bool paused{ false };
+    std::atomic_size_t received{ 0 };
+    std::atomic<nx::tcp*> server{ nullptr };
+
+    auto endpoint = nx::serve<nx::tcp>(
+        nx::make_endpoint_tcp("127.0.0.1", 0),
+        [&](nx::tcp& t) {
+            t.read_watermarks(high, low);
+            server = &t;
+        },
+        [&](nx::tcp& t) {
+            if (!draining) {
+                // Leave input in the receive buffer
+                return;
+            }
+
+            nx::buffer b;
+
+            t >> b;
+            received += b.size();
+
+            if (received == total) {
+                deadline.stop();
+                cv.notify();
+            }
+        }
+    );
+
+    nx::connect<nx::tcp>(
+        endpoint,
+        [&](nx::tcp& t) {
+            t << std::string(total, 'x');
+        }
+    );
+
+    nx::after(std::chrono::milliseconds(500)) << [&]() {
+        auto& t = *server.load();
+
+        paused = t.read_paused();
+
+        nx::buffer b;
+
+        t >> b;
+        received += b.size();
+        draining = true;
+        t.resume_read();
+    };
+
+    cv.wait();
+    nx::stop();
+
+    BOOST_CHECK_MESSAGE(paused, "server paused reading");
+    BOOST_CHECK_MESSAGE(received == total, "server got all data");
+}
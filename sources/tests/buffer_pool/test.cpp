@@ -0,0 +1,89 @@
+#define BOOST_TEST_MODULE buffer_pool
+
+#include <iostream>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/buffer_pool.hpp>
+
+BOOST_AUTO_TEST_CASE(buffer_pool)
+{
+    auto& pool = nx::buffer_pool::get();
+
+    auto b = pool.acquire(100);
+
+    BOOST_CHECK_MESSAGE(b.empty(), "acquired buffer is empty");
+    BOOST_CHECK_MESSAGE(
+        b.capacity() >= nx::buffer_pool::min_size,
+        "acquired buffer has at least the smallest class capacity"
+    );
+
+    b.resize(10);
+    auto data = b.data();
+
+    pool.release(b);
+
+    BOOST_CHECK_MESSAGE(b.capacity() == 0, "released buffer lost its storage");
+
+    auto c = pool.acquire(10);
+
+    BOOST_CHECK_MESSAGE(c.data() == data, "storage was recycled");
+
+    auto big = pool.acquire(nx::buffer_pool::max_size + 1);
+
+    BOOST_CHECK_MESSAGE(
+        big.capacity() > nx::buffer_pool::max_size,
+        "oversized buffers are still served"
+    );
+
+    pool.release(c);
+    pool.release(big);
+
+    // Raw buffers keep their contents across resize() and are pooled apart
+    auto r = pool.acquire_raw(100);
+
+    r.resize(r.capacity());
+    r[0] = 'x';
+    r.resize(0);
+    r.resize(1);
+
+    BOOST_CHECK_MESSAGE(r[0] == 'x', "raw buffer resize leaves bytes alone");
+
+    auto raw_data = r.data();
+
+    pool.release(r);
+
+    BOOST_CHECK_MESSAGE(
+        pool.acquire(10).data() != raw_data,
+        "raw storage is not handed out as a buffer"
+    );
+    BOOST_CHECK_MESSAGE(
+        pool.acquire_raw(10).data() == raw_data,
+        "raw storage was recycled"
+    );
+
+    pool.trim();
+}
+
+BOOST_AUTO_TEST_CASE(read_size)
+{
+    nx::read_size rs;
+
+    auto initial = rs();
+
+    rs.update(initial);
+
+    BOOST_CHECK_MESSAGE(rs() == 2 * initial, "full reads grow read size");
+
+    for (std::size_t i = 0; i < nx::read_size::shrink_after; i++) {
+        rs.update(1);
+    }
+
+    BOOST_CHECK_MESSAGE(rs() == initial, "short reads shrink read size");
+
+    for (std::size_t i = 0; i < 4 * nx::read_size::shrink_after; i++) {
+        rs.update(0);
+    }
+
+    BOOST_CHECK_MESSAGE(rs() == initial, "read size stays above minimum");
+}
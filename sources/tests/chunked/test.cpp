@@ -0,0 +1,133 @@
+#define BOOST_TEST_MODULE chunked
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/nx.hpp>
+#include <nx/utils.hpp>
+
+/*
+ * Streamed replies send headers right away, then one chunk per flush and a
+ * terminating chunk when done. HTTP clients get them decoded.
+ */
+
+BOOST_AUTO_TEST_CASE(chunked)
+{
+    using namespace nx;
+    using namespace nx::tags;
+
+    nx::timer deadline;
+    nx::cond_var cv;
+
+    deadline(5) = [&](nx::timer& t) {
+        t.stop();
+        cv.notify();
+    };
+
+    deadline.start();
+
+    httpd hd;
+
+    std::atomic_bool finished{ false };
+    std::atomic_bool early{ false };
+
+    hd(GET) / "export" = [&](const request& req, buffer& data, reply& rep) {
+        rep << text_plain;
+        rep.stream();
+
+        std::thread(
+            [&]() {
+                for (auto part : { "abc", "0123456789abcdef", "z" }) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                    rep << part;
+                    rep.flush();
+                }
+
+                finished = true;
+                rep.done();
+            }
+        ).detach();
+    };
+
+    auto sep = hd(make_endpoint("127.0.0.1"));
+
+    std::string received;
+    std::atomic_bool closed{ false };
+
+    auto c = nx::new_object<nx::tcp>();
+    auto& client = *c;
+
+    client[on_close] = [&](nx::tcp& t) {
+        closed = true;
+        cv.notify();
+    };
+
+    nx::connect(
+        client,
+        sep.ep_tcp,
+        [&](nx::tcp& t) {
+            t[on_read] = [&](nx::tcp& t) {
+                nx::buffer b;
+
+                if (received.empty() && !finished) {
+                    early = true;
+                }
+
+                t >> b;
+                received.append(b.begin(), b.end());
+            };
+
+            t
+                << "GET /export HTTP/1.1\r\n"
+                << "Host: test\r\n"
+                << "Connection: close\r\n"
+                << "\r\n"
+                ;
+        }
+    );
+
+    cv.wait();
+
+    httpc_sync hcs;
+    std::string decoded;
+
+    hcs(GET, sep) / "export" = [&](const reply& rep, buffer& data) {
+        decoded.assign(data.begin(), data.end());
+    };
+
+    deadline.stop();
+    nx::stop();
+
+    auto body_pos = received.find("\r\n\r\n");
+
+    BOOST_CHECK_MESSAGE(early, "headers sent before reply is done");
+    BOOST_CHECK_MESSAGE(
+        received.find("Transfer-Encoding: chunked\r\n") < body_pos,
+        "chunked transfer encoding"
+    );
+    BOOST_CHECK_MESSAGE(
+        received.find("Content-Length") == std::string::npos,
+        "no content length"
+    );
+    BOOST_CHECK_MESSAGE(
+        body_pos != std::string::npos
+        &&
+        received.substr(body_pos + 4)
+        ==
+        "3\r\nabc\r\n"
+        "10\r\n0123456789abcdef\r\n"
+        "1\r\nz\r\n"
+        "0\r\n\r\n",
+        "chunks and terminator"
+    );
+    BOOST_CHECK_MESSAGE(closed, "connection closed on request");
+    BOOST_CHECK_MESSAGE(
+        decoded == "abc0123456789abcdefz",
+        "chunked reply decoded by client"
+    );
+}
@@ -0,0 +1,63 @@
+#define BOOST_TEST_MODULE function
+
+#include <iostream>
+#include <memory>
+#include <functional>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/function.hpp>
+
+BOOST_AUTO_TEST_CASE(unique_function)
+{
+    nx::unique_function<int(int)> empty;
+
+    BOOST_CHECK_MESSAGE(!empty, "default function is empty");
+
+    // Move-only capture
+    auto p = std::make_unique<int>(40);
+    nx::unique_function<int(int)> small = [p = std::move(p)](int v) {
+        return *p + v;
+    };
+
+    BOOST_CHECK_MESSAGE(small && small(2) == 42, "small callable is called");
+
+    auto moved = std::move(small);
+
+    BOOST_CHECK_MESSAGE(!small, "moved from function is empty");
+    BOOST_CHECK_MESSAGE(moved(2) == 42, "moved function keeps its callable");
+
+    // Callable too large for inline storage
+    char big[128] = { 1 };
+    nx::unique_function<int()> large = [big]() { return (int) big[0]; };
+    nx::unique_function<int()> large_moved = std::move(large);
+
+    BOOST_CHECK_MESSAGE(large_moved() == 1, "large callable is called");
+
+    // Results are discarded for void signatures
+    bool called = false;
+    nx::unique_function<void()> discard = [&]() { called = true; return 1; };
+
+    discard();
+
+    BOOST_CHECK_MESSAGE(called, "void function calls non-void callable");
+
+    // Empty std::function stays empty
+    std::function<void()> none;
+    nx::unique_function<void()> from_none = none;
+
+    BOOST_CHECK_MESSAGE(!from_none, "empty std::function gives empty function");
+
+    // Destruction releases captures
+    auto shared = std::make_shared<int>(0);
+
+    {
+        nx::unique_function<void()> holder = [shared]() {};
+
+        BOOST_CHECK_MESSAGE(shared.use_count() == 2, "capture is held");
+
+        holder = nullptr;
+
+        BOOST_CHECK_MESSAGE(shared.use_count() == 1, "capture is released");
+    }
+}
@@ -0,0 +1,92 @@
+#define BOOST_TEST_MODULE header_views
+
+#include <iostream>
+#include <string>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/request.hpp>
+#include <nx/reply.hpp>
+
+/*
+ * Parsed headers are looked up case-insensitively as views, outlive the
+ * buffer they were parsed from and become strings only when asked for.
+ */
+
+BOOST_AUTO_TEST_CASE(header_views)
+{
+    using namespace nx;
+
+    nx::buffer b;
+    std::string head =
+        "POST /upload HTTP/1.1\r\n"
+        "Host: test\r\n"
+        "X-Custom-Header: Some Value\r\n"
+        "Content-Length: 12\r\n"
+        "\r\n"
+        ;
+
+    b.assign(head.begin(), head.end());
+
+    request req;
+
+    BOOST_CHECK_MESSAGE(req.parse(b), "request parsed");
+    BOOST_CHECK_MESSAGE(b.empty(), "head consumed");
+
+    // Receive buffer storage is reused for the next input
+    b.assign(head.size(), '#');
+
+    BOOST_CHECK_MESSAGE(req.content_length() == 12, "content length");
+    BOOST_CHECK_MESSAGE(req.has("x-custom-header"), "lowercase lookup");
+    BOOST_CHECK_MESSAGE(req.has("X-CUSTOM-HEADER"), "uppercase lookup");
+    BOOST_CHECK_MESSAGE(!req.has("X-Missing"), "missing header");
+    BOOST_CHECK_MESSAGE(
+        req.hv("x-custom-header") == "Some Value",
+        "header view"
+    );
+    BOOST_CHECK_MESSAGE(req.hv("x-missing").empty(), "missing header view");
+    BOOST_CHECK_MESSAGE(
+        req.has(header{ "host", "test" }),
+        "header and value match"
+    );
+    BOOST_CHECK_MESSAGE(
+        !req.has(header{ "host", "other" }),
+        "header value mismatch"
+    );
+    BOOST_CHECK_MESSAGE(
+        req.h("X-Custom-Header") == "Some Value",
+        "header as string"
+    );
+
+    const request& creq = req;
+
+    BOOST_CHECK_MESSAGE(creq.h("X-Missing").empty(), "missing const header");
+    BOOST_CHECK_MESSAGE(
+        creq.h("x-custom-header") == "Some Value",
+        "const header as string"
+    );
+
+    // Headers set on the message take over parsed ones
+    req << header{ "X-Custom-Header", "Other Value" };
+
+    BOOST_CHECK_MESSAGE(
+        req.hv("Host") == "test",
+        "parsed header view after setting another one"
+    );
+
+    auto all = req.all_headers();
+
+    BOOST_CHECK_MESSAGE(all.has("Host"), "all headers include parsed ones");
+    BOOST_CHECK_MESSAGE(all.has("X-Custom-Header"), "all headers include set ones");
+
+    // Moved messages keep their headers
+    request moved(std::move(req));
+
+    BOOST_CHECK_MESSAGE(moved.has("host"), "moved request headers");
+    BOOST_CHECK_MESSAGE(moved.h("Host") == "test", "moved request header value");
+
+    // Cleared messages forget them
+    moved.clear();
+
+    BOOST_CHECK_MESSAGE(!moved.has("host"), "cleared request headers");
+}
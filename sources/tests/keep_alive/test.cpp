@@ -0,0 +1,279 @@
+#define BOOST_TEST_MODULE keep_alive
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <chrono>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/nx.hpp>
+#include <nx/utils.hpp>
+
+/*
+ * Requests sent one after the other on a single connection all get a
+ * reply, until the client asks for the connection to be closed. Idle
+ * connections are closed by the server, also when no request or only part
+ * of its head was ever sent.
+ */
+
+std::size_t
+count_replies(const std::string& data)
+{
+    std::size_t count = 0;
+    std::size_t pos = 0;
+
+    while ((pos = data.find("HTTP/1.1 200", pos)) != std::string::npos) {
+        count++;
+        pos++;
+    }
+
+    return count;
+}
+
+BOOST_AUTO_TEST_CASE(keep_alive)
+{
+    using namespace nx;
+    using namespace nx::tags;
+
+    nx::timer deadline;
+    nx::cond_var cv;
+
+    deadline(5) = [&](nx::timer& t) {
+        t.stop();
+        cv.notify();
+    };
+
+    deadline.start();
+
+    httpd hd;
+
+    http_keep_alive k;
+    k.idle_timeout = std::chrono::milliseconds(200);
+    hd << k;
+
+    std::atomic_size_t requests{ 0 };
+
+    hd(GET) / "hello" = [&](const request& req, buffer& data, reply& rep) {
+        requests++;
+        rep << text_plain << "hello";
+    };
+
+    hd(GET) / "bye" = [&](const request& req, buffer& data, reply& rep) {
+        requests++;
+        rep << connection_close << text_plain << "bye";
+    };
+
+    hd(GET) / "stream" = [&](const request& req, buffer& data, reply& rep) {
+        rep.stream();
+        rep << "streamed";
+        rep.done();
+    };
+
+    auto sep = hd(make_endpoint("127.0.0.1"));
+
+    const std::string get = "GET /hello HTTP/1.1\r\nHost: test\r\n\r\n";
+    const std::string get_close =
+        "GET /hello HTTP/1.1\r\nHost: test\r\nConnection: close\r\n\r\n";
+
+    std::string received;
+    std::size_t sent = 0;
+    std::atomic_bool closed{ false };
+
+    auto c = nx::new_object<nx::tcp>();
+    auto& client = *c;
+
+    client[on_close] = [&](nx::tcp& t) {
+        closed = true;
+        cv.notify();
+    };
+
+    nx::connect(
+        client,
+        sep.ep_tcp,
+        [&](nx::tcp& t) {
+            t[on_read] = [&](nx::tcp& t) {
+                nx::buffer b;
+
+                t >> b;
+                received.append(b.begin(), b.end());
+
+                if (count_replies(received) == sent && sent < 3) {
+                    // Previous reply is in, send the next request
+                    t << (++sent == 3 ? get_close : get);
+                }
+            };
+
+            sent++;
+            t << get;
+        }
+    );
+
+    cv.wait();
+
+    BOOST_CHECK_MESSAGE(requests == 3, "requests served on one connection");
+    BOOST_CHECK_MESSAGE(count_replies(received) == 3, "all requests replied");
+    BOOST_CHECK_MESSAGE(closed, "connection closed on request");
+
+    // Idle connection
+    closed = false;
+    cv.reset();
+
+    auto i = nx::new_object<nx::tcp>();
+    auto& idle = *i;
+    auto start = std::chrono::steady_clock::now();
+
+    idle[on_close] = [&](nx::tcp& t) {
+        closed = true;
+        cv.notify();
+    };
+
+    nx::connect(
+        idle,
+        sep.ep_tcp,
+        [&](nx::tcp& t) {
+            t[on_read] = [&](nx::tcp& t) {
+                nx::buffer b;
+                t >> b;
+            };
+
+            t << get;
+        }
+    );
+
+    cv.wait();
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    BOOST_CHECK_MESSAGE(closed, "idle connection closed");
+    BOOST_CHECK_MESSAGE(
+        elapsed < std::chrono::seconds(2),
+        "idle connection closed after idle timeout"
+    );
+
+    // Silent client, then one stopping half-way through a request head
+    for (const std::string& data : { std::string(), get.substr(0, 20) }) {
+        closed = false;
+        requests = 0;
+        cv.reset();
+
+        auto q = nx::new_object<nx::tcp>();
+        auto& quiet = *q;
+
+        start = std::chrono::steady_clock::now();
+
+        quiet[on_close] = [&](nx::tcp& t) {
+            closed = true;
+            cv.notify();
+        };
+
+        nx::connect(
+            quiet,
+            sep.ep_tcp,
+            [&, data](nx::tcp& t) {
+                t[on_read] = [&](nx::tcp& t) {
+                    nx::buffer b;
+                    t >> b;
+                };
+
+                if (!data.empty()) {
+                    t << data;
+                }
+            }
+        );
+
+        cv.wait();
+
+        elapsed = std::chrono::steady_clock::now() - start;
+
+        BOOST_CHECK_MESSAGE(closed, "quiet connection closed");
+        BOOST_CHECK_MESSAGE(requests == 0, "no request from quiet connection");
+        BOOST_CHECK_MESSAGE(
+            elapsed < std::chrono::seconds(2),
+            "quiet connection closed after idle timeout"
+        );
+    }
+
+    // Handler closing the connection, the pipelined request after it
+    // is dropped
+    closed = false;
+    requests = 0;
+    cv.reset();
+
+    std::string bye_received;
+    auto b = nx::new_object<nx::tcp>();
+    auto& bye = *b;
+
+    bye[on_close] = [&](nx::tcp& t) {
+        closed = true;
+        cv.notify();
+    };
+
+    nx::connect(
+        bye,
+        sep.ep_tcp,
+        [&](nx::tcp& t) {
+            t[on_read] = [&](nx::tcp& t) {
+                nx::buffer b;
+
+                t >> b;
+                bye_received.append(b.begin(), b.end());
+            };
+
+            t << "GET /bye HTTP/1.1\r\nHost: test\r\n\r\n" + get;
+        }
+    );
+
+    cv.wait();
+
+    BOOST_CHECK_MESSAGE(closed, "connection closed by handler");
+    BOOST_CHECK_MESSAGE(requests == 1, "request after the last one dropped");
+    BOOST_CHECK_MESSAGE(count_replies(bye_received) == 1, "last reply sent");
+    BOOST_CHECK_MESSAGE(
+        bye_received.find("keep-alive") == std::string::npos,
+        "no keep-alive on a closing reply"
+    );
+
+    // HTTP/1.0 streamed reply ends with the connection
+    closed = false;
+    cv.reset();
+
+    std::string stream_received;
+    auto s = nx::new_object<nx::tcp>();
+    auto& stream = *s;
+
+    stream[on_close] = [&](nx::tcp& t) {
+        closed = true;
+        cv.notify();
+    };
+
+    nx::connect(
+        stream,
+        sep.ep_tcp,
+        [&](nx::tcp& t) {
+            t[on_read] = [&](nx::tcp& t) {
+                nx::buffer b;
+
+                t >> b;
+                stream_received.append(b.begin(), b.end());
+            };
+
+            t << "GET /stream HTTP/1.0\r\nConnection: keep-alive\r\n\r\n";
+        }
+    );
+
+    cv.wait();
+    deadline.stop();
+
+    nx::stop();
+
+    BOOST_CHECK_MESSAGE(closed, "streamed HTTP/1.0 reply closed");
+    BOOST_CHECK_MESSAGE(
+        stream_received.find("Connection: close") != std::string::npos,
+        "streamed HTTP/1.0 reply closes"
+    );
+    BOOST_CHECK_MESSAGE(
+        stream_received.find("keep-alive") == std::string::npos,
+        "streamed HTTP/1.0 reply has no keep-alive"
+    );
+}
@@ -0,0 +1,86 @@
+#define BOOST_TEST_MODULE late_routes
+
+#include <string>
+#include <stdexcept>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/nx.hpp>
+#include <nx/utils.hpp>
+
+/*
+ * Routes may be added while serving: a route is served once its handler is
+ * set, never with the path it had when a request came in before that. Bad
+ * routes are reported when their handler is set and never served.
+ */
+
+BOOST_AUTO_TEST_CASE(late_routes)
+{
+    using namespace nx;
+
+    httpd hd;
+
+    hd(GET) / "hello" = [](const request& req, buffer& data, reply& rep) {
+        rep << text_plain << "hello";
+    };
+
+    auto sep = hd(make_endpoint("127.0.0.1"));
+
+    auto get = [&](const std::string& path) {
+        httpc_sync hcs;
+        int status = 0;
+
+        hcs(GET, sep) / path = [&](const reply& rep, buffer& data) {
+            status = rep.code().code;
+        };
+
+        return status;
+    };
+
+    // Routes without handler yet, the second one without path either
+    auto& late = hd(GET) / "late";
+    auto& later = hd(GET);
+
+    BOOST_CHECK_MESSAGE(get("hello") == 200, "served before late routes");
+    BOOST_CHECK_MESSAGE(get("late") == 404, "incomplete route not served");
+
+    bool got_late = false;
+    bool got_later = false;
+
+    late = [&](const request& req, buffer& data, reply& rep) {
+        got_late = true;
+        rep << text_plain << "late";
+    };
+
+    later / "later" = [&](const request& req, buffer& data, reply& rep) {
+        got_later = true;
+        rep << text_plain << "later";
+    };
+
+    BOOST_CHECK_MESSAGE(get("late") == 200, "late route served");
+    BOOST_CHECK_MESSAGE(get("later") == 200, "route with late path served");
+    BOOST_CHECK_MESSAGE(got_late && got_later, "late route handlers called");
+    BOOST_CHECK_MESSAGE(get("hello") == 200, "earlier route still served");
+
+    auto handler = [](const request& req, buffer& data, reply& rep) {
+        rep << text_plain << "bad";
+    };
+
+    BOOST_CHECK_THROW(
+        hd(GET) / "*rest" / "tail" = handler,
+        std::runtime_error
+    );
+
+    auto& many = hd(GET) / "many";
+
+    for (std::size_t i = 0; i <= router::max_captures; i++) {
+        many / (":c" + std::to_string(i));
+    }
+
+    BOOST_CHECK_THROW(many = handler, std::runtime_error);
+
+    BOOST_CHECK_MESSAGE(get("hello") == 200, "served after bad routes");
+    BOOST_CHECK_MESSAGE(get("late") == 200, "late route served after bad routes");
+
+    nx::stop();
+}
@@ -0,0 +1,105 @@
+#define BOOST_TEST_MODULE message_head
+
+#include <iostream>
+#include <string>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/request.hpp>
+#include <nx/reply.hpp>
+
+/*
+ * Message heads are written straight into a buffer, standard status lines
+ * being rendered once.
+ */
+
+std::string
+head_of(const nx::http_msg_base& m)
+{
+    nx::buffer b;
+
+    m.write_head(b);
+
+    return std::string(b.begin(), b.end());
+}
+
+BOOST_AUTO_TEST_CASE(message_head)
+{
+    using namespace nx;
+
+    BOOST_CHECK_MESSAGE(status_line(OK) == "HTTP/1.1 200 OK\r\n", "OK line");
+    BOOST_CHECK_MESSAGE(
+        status_line(NotFound) == "HTTP/1.1 404 Not Found\r\n",
+        "NotFound line"
+    );
+    BOOST_CHECK_MESSAGE(
+        status_line(http_status{ 200, "Fine" }).empty(),
+        "custom status text"
+    );
+    BOOST_CHECK_MESSAGE(
+        status_line(http_status{ 299, "Other" }).empty(),
+        "custom status code"
+    );
+
+    reply rep;
+
+    rep << text_plain << "hello";
+
+    BOOST_CHECK_MESSAGE(
+        head_of(rep) ==
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 5\r\n"
+        "\r\n",
+        "reply head"
+    );
+    BOOST_CHECK_MESSAGE(rep.header_data() == head_of(rep), "header data");
+
+    reply custom;
+
+    custom << http_status{ 299, "Other" };
+
+    BOOST_CHECK_MESSAGE(
+        head_of(custom) ==
+        "HTTP/1.1 299 Other\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n",
+        "custom status head"
+    );
+
+    reply sized;
+
+    sized << header{ Content_Length, "12" };
+
+    BOOST_CHECK_MESSAGE(
+        head_of(sized) ==
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Length: 12\r\n"
+        "\r\n",
+        "content length set by handler"
+    );
+
+    request req(POST);
+
+    req / "items";
+
+    req << application_json << "{}";
+
+    BOOST_CHECK_MESSAGE(
+        head_of(req) ==
+        "POST /items HTTP/1.1\r\n"
+        "Content-Type: application/json\r\n"
+        "Content-Length: 2\r\n"
+        "\r\n",
+        "request head"
+    );
+
+    request get(GET);
+
+    get / "items";
+
+    BOOST_CHECK_MESSAGE(
+        head_of(get) == "GET /items HTTP/1.1\r\n\r\n",
+        "GET request head"
+    );
+}
@@ -0,0 +1,75 @@
+#define BOOST_TEST_MODULE methods
+
+#include <iostream>
+#include <string>
+#include <deque>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/router.hpp>
+
+/*
+ * Standard methods are parsed into verbs, extension methods keep their name
+ * only. Both are routed.
+ */
+
+BOOST_AUTO_TEST_CASE(method_verbs)
+{
+    using namespace nx;
+
+    BOOST_CHECK_MESSAGE(verb_of("GET") == verb::get, "GET");
+    BOOST_CHECK_MESSAGE(verb_of("DELETE") == verb::delete_, "DELETE");
+    BOOST_CHECK_MESSAGE(verb_of("CONNECT") == verb::connect, "CONNECT");
+    BOOST_CHECK_MESSAGE(verb_of("get") == verb::other, "case sensitive");
+    BOOST_CHECK_MESSAGE(verb_of("PURGE") == verb::other, "extension method");
+    BOOST_CHECK_MESSAGE(std::string(verb_name(verb::patch)) == "PATCH", "name");
+
+    nx::buffer b;
+    std::string head =
+        "PATCH /items/1 HTTP/1.1\r\n"
+        "Host: test\r\n"
+        "\r\n"
+        ;
+
+    b.assign(head.begin(), head.end());
+
+    request req;
+
+    BOOST_CHECK_MESSAGE(req.parse(b), "request parsed");
+    BOOST_CHECK_MESSAGE(req.verb() == verb::patch, "parsed verb");
+    BOOST_CHECK_MESSAGE(req.method() == "PATCH", "parsed method");
+    BOOST_CHECK_MESSAGE(req == PATCH, "method compare");
+    BOOST_CHECK_MESSAGE(req != GET, "other method compare");
+
+    request ext("PURGE", "/items/1");
+
+    BOOST_CHECK_MESSAGE(ext.verb() == verb::other, "extension verb");
+    BOOST_CHECK_MESSAGE(ext == method{ ext.method() }, "extension compare");
+
+    std::deque<route> routes(3);
+
+    auto& patch = routes[0] / "items" / ":id";
+    auto& purge = routes[1] / "items" / ":id";
+    auto& get = routes[2] / "items" / ":id";
+
+    router r;
+
+    r.add("PATCH", patch);
+    r.add("PURGE", purge);
+    r.add(verb::get, get);
+
+    BOOST_CHECK_MESSAGE(r.find(req) == &patch, "standard method route");
+    BOOST_CHECK_MESSAGE(r.find(ext) == &purge, "extension method route");
+
+    request head_req(HEAD);
+
+    head_req / "items" / "1";
+
+    BOOST_CHECK_MESSAGE(r.find(head_req) == nullptr, "no route for method");
+
+    request get_req(GET);
+
+    get_req / "items" / "1";
+
+    BOOST_CHECK_MESSAGE(r.find(get_req) == &get, "route added by verb");
+}
@@ -0,0 +1,52 @@
+#define BOOST_TEST_MODULE object_pool
+
+#include <iostream>
+#include <memory>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/object_pool.hpp>
+
+struct pooled
+{
+    char data[200];
+};
+
+BOOST_AUTO_TEST_CASE(object_pool)
+{
+    nx::pool_allocator<pooled> a;
+    auto& pool = a.pool();
+
+    auto b1 = a.allocate(1);
+
+    a.deallocate(b1, 1);
+
+    BOOST_CHECK_MESSAGE(pool.size() == 1, "released storage is pooled");
+
+    auto b2 = a.allocate(1);
+
+    BOOST_CHECK_MESSAGE(b2 == b1, "pooled storage is reused");
+    BOOST_CHECK_MESSAGE(pool.size() == 0, "reused storage left the pool");
+
+    a.deallocate(b2, 1);
+    nx::object_pool::trim_all();
+
+    BOOST_CHECK_MESSAGE(pool.size() == 0, "trimmed pool is empty");
+
+    nx::object_pool::set_max_free(0);
+    a.deallocate(a.allocate(1), 1);
+
+    BOOST_CHECK_MESSAGE(pool.size() == 0, "pooling can be disabled");
+
+    nx::object_pool::set_max_free(nx::object_pool::default_max_free);
+
+    // Shared objects, control block included
+    auto p1 = std::allocate_shared<pooled>(a);
+    auto raw = p1.get();
+
+    p1.reset();
+
+    auto p2 = std::allocate_shared<pooled>(a);
+
+    BOOST_CHECK_MESSAGE(p2.get() == raw, "shared object storage is reused");
+}
@@ -0,0 +1,92 @@
+#define BOOST_TEST_MODULE object_registry
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/object_registry.hpp>
+
+struct counted : nx::object_base
+{
+    counted(std::atomic_size_t& live)
+    : live_(live)
+    { live_++; }
+
+    ~counted()
+    { live_--; }
+
+    void stop()
+    {}
+
+    std::atomic_size_t& live_;
+};
+
+BOOST_AUTO_TEST_CASE(object_registry)
+{
+    const std::size_t threads_count = 4;
+    const std::size_t objects = 10000;
+
+    std::atomic_size_t live{ 0 };
+    nx::object_registry r;
+
+    {
+        auto o = std::make_shared<counted>(live);
+        nx::object_ptr p = o;
+
+        r.add(p);
+        r.add(p);
+        o.reset();
+        p.reset();
+
+        BOOST_CHECK_MESSAGE(live == 1, "registry keeps objects alive");
+        BOOST_CHECK_MESSAGE(r.objects().size() == 1, "object registered once");
+
+        auto registered = r.objects().front();
+
+        r.remove(registered);
+        r.remove(registered);
+
+        BOOST_CHECK_MESSAGE(r.objects().empty(), "object removed");
+    }
+
+    BOOST_CHECK_MESSAGE(live == 0, "removed object destroyed");
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t t = 0; t < threads_count; t++) {
+        threads.emplace_back(
+            [&]() {
+                for (std::size_t i = 0; i < objects; i++) {
+                    nx::object_ptr p = std::make_shared<counted>(live);
+
+                    r.add(p);
+
+                    if (i % 2 == 0) {
+                        r.remove(p);
+                    }
+                }
+            }
+        );
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    BOOST_CHECK_MESSAGE(
+        r.objects().size() == threads_count * objects / 2,
+        "registry holds objects not removed"
+    );
+    BOOST_CHECK_MESSAGE(
+        live == threads_count * objects / 2,
+        "removed objects destroyed"
+    );
+
+    r.clear();
+
+    BOOST_CHECK_MESSAGE(r.objects().empty(), "registry cleared");
+    BOOST_CHECK_MESSAGE(live == 0, "cleared objects destroyed");
+}
@@ -0,0 +1,201 @@
+#define BOOST_TEST_MODULE pipelining
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/nx.hpp>
+#include <nx/utils.hpp>
+
+/*
+ * Requests pipelined in a single write are all dispatched, and replies come
+ * back in request order even when the first one is postponed. Input left
+ * waiting for a postponed reply doesn't mix with input arriving after it.
+ */
+
+BOOST_AUTO_TEST_CASE(pipelining)
+{
+    using namespace nx;
+    using namespace nx::tags;
+
+    nx::timer deadline;
+    nx::cond_var cv;
+
+    deadline(5) = [&](nx::timer& t) {
+        t.stop();
+        cv.notify();
+    };
+
+    deadline.start();
+
+    httpd hd;
+
+    std::atomic_size_t requests{ 0 };
+    std::atomic_bool fast_before_slow{ false };
+    std::atomic_bool slow_done{ false };
+
+    hd(GET) / "slow" = [&](const request& req, buffer& data, reply& rep) {
+        requests++;
+        rep.postpone();
+
+        std::thread(
+            [&]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                rep << text_plain << "<slow>";
+                slow_done = true;
+                rep.done();
+            }
+        ).detach();
+    };
+
+    hd(GET) / "fast" / ":n" = [&](const request& req, buffer& data, reply& rep) {
+        requests++;
+
+        if (!slow_done) {
+            // Dispatched while the slow reply is pending
+            fast_before_slow = true;
+        }
+
+        rep << text_plain << "<fast" << req.a("n") << ">";
+    };
+
+    auto sep = hd(make_endpoint("127.0.0.1"));
+
+    const std::string pipelined =
+        "GET /slow HTTP/1.1\r\nHost: test\r\n\r\n"
+        "GET /fast/1 HTTP/1.1\r\nHost: test\r\n\r\n"
+        "GET /fast/2 HTTP/1.1\r\nHost: test\r\nConnection: close\r\n\r\n"
+        ;
+
+    std::string received;
+    std::atomic_bool closed{ false };
+
+    auto c = nx::new_object<nx::tcp>();
+    auto& client = *c;
+
+    client[on_close] = [&](nx::tcp& t) {
+        closed = true;
+        cv.notify();
+    };
+
+    nx::connect(
+        client,
+        sep.ep_tcp,
+        [&](nx::tcp& t) {
+            t[on_read] = [&](nx::tcp& t) {
+                nx::buffer b;
+
+                t >> b;
+                received.append(b.begin(), b.end());
+            };
+
+            t << pipelined;
+        }
+    );
+
+    cv.wait();
+
+    // One request in flight, the next ones wait in the receive buffer
+    // while the first reply is postponed
+    httpd one_hd;
+    http_keep_alive k;
+
+    k.max_pipelined = 1;
+    one_hd << k;
+
+    std::mutex paths_mutex;
+    std::vector<std::string> paths;
+
+    one_hd(GET) / ":p" = [&](const request& req, buffer& data, reply& rep) {
+        bool first = false;
+
+        {
+            std::lock_guard<std::mutex> lock(paths_mutex);
+            paths.push_back(req.a("p"));
+            first = paths.size() == 1;
+        }
+
+        if (!first) {
+            return;
+        }
+
+        rep.postpone();
+
+        std::thread(
+            [&]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                rep.done();
+            }
+        ).detach();
+    };
+
+    auto one_sep = one_hd(make_endpoint("127.0.0.1"));
+
+    std::atomic_bool later_closed{ false };
+
+    cv.reset();
+
+    auto l = nx::new_object<nx::tcp>();
+    auto& later = *l;
+
+    later[on_close] = [&](nx::tcp& t) {
+        later_closed = true;
+        cv.notify();
+    };
+
+    nx::connect(
+        later,
+        one_sep.ep_tcp,
+        [&](nx::tcp& t) {
+            t[on_read] = [&](nx::tcp& t) {
+                nx::buffer b;
+                t >> b;
+            };
+
+            t
+                << "GET /one HTTP/1.1\r\nHost: test\r\n\r\n"
+                << "GET /two HTTP/1.1\r\nHost: test\r\n\r\n"
+                ;
+        }
+    );
+
+    nx::after(std::chrono::milliseconds(300)) << [&]() {
+        later << "GET /333 HTTP/1.1\r\nHost: test\r\nConnection: close\r\n\r\n";
+    };
+
+    cv.wait();
+    deadline.stop();
+    nx::stop();
+
+    BOOST_CHECK_MESSAGE(later_closed, "connection closed after later input");
+    BOOST_CHECK_MESSAGE(
+        join(" ", paths) == "one two 333",
+        "input after a postponed reply: " + join(" ", paths)
+    );
+
+    auto slow = received.find("<slow>");
+    auto fast1 = received.find("<fast1>");
+    auto fast2 = received.find("<fast2>");
+
+    BOOST_CHECK_MESSAGE(requests == 3, "all pipelined requests dispatched");
+    BOOST_CHECK_MESSAGE(fast_before_slow, "requests dispatched ahead of replies");
+    BOOST_CHECK_MESSAGE(
+        slow != std::string::npos
+        &&
+        fast1 != std::string::npos
+        &&
+        fast2 != std::string::npos,
+        "all requests replied"
+    );
+    BOOST_CHECK_MESSAGE(
+        slow < fast1 && fast1 < fast2,
+        "replies in request order"
+    );
+    BOOST_CHECK_MESSAGE(closed, "connection closed on last request");
+}
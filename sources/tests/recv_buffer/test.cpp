@@ -0,0 +1,163 @@
+#define BOOST_TEST_MODULE recv_buffer
+
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <atomic>
+#include <chrono>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/nx.hpp>
+#include <nx/recv_buffer.hpp>
+#include <nx/request.hpp>
+
+namespace {
+
+void
+append(nx::recv_buffer& b, const std::string& s)
+{
+    auto p = b.prepare(s.size());
+    std::memcpy(p, s.data(), s.size());
+    b.commit(s.size());
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(recv_buffer)
+{
+    nx::recv_buffer b;
+
+    BOOST_CHECK_MESSAGE(b.empty(), "new buffer is empty");
+
+    append(b, "hello, world");
+    auto front = b.data();
+
+    b.consume(7);
+
+    BOOST_CHECK_MESSAGE(
+        std::string(b.begin(), b.end()) == "world",
+        "consume drops data from the front"
+    );
+    BOOST_CHECK_MESSAGE(b.data() == front + 7, "consume does not move data");
+
+    // A read may be pending at the address prepare() returned
+    auto pending = b.prepare(5);
+
+    b.consume(5);
+
+    BOOST_CHECK_MESSAGE(b.empty(), "buffer is empty once all is consumed");
+
+    std::memcpy(pending, "again", 5);
+    b.commit(5);
+
+    BOOST_CHECK_MESSAGE(
+        std::string(b.begin(), b.end()) == "again",
+        "input written after a consume is read as is"
+    );
+
+    b.clear();
+
+    BOOST_CHECK_MESSAGE(b.prepare(1) == front, "cursors rewind when empty");
+
+    // Fill up, consume a bit, then ask for more than the free tail
+    std::string big(b.capacity(), 'x');
+
+    append(b, big);
+    b.consume(10);
+    append(b, "tail");
+
+    std::string content(b.begin(), b.end());
+
+    BOOST_CHECK_MESSAGE(
+        content == big.substr(10) + "tail",
+        "unread data survives compaction and growth"
+    );
+
+    std::string s;
+    b >> s;
+
+    BOOST_CHECK_MESSAGE(s == content && b.empty(), "streaming out drains buffer");
+}
+
+BOOST_AUTO_TEST_CASE(pipelined_requests)
+{
+    nx::recv_buffer b;
+
+    append(
+        b,
+        "GET /one HTTP/1.1\r\nHost: a\r\n\r\n"
+        "GET /two HTTP/1.1\r\nHost: a\r\n\r\n"
+    );
+
+    nx::request r1;
+    nx::request r2;
+
+    BOOST_CHECK(r1.parse(b));
+    BOOST_CHECK(r2.parse(b));
+    BOOST_CHECK_EQUAL(r1.path(), "/one");
+    BOOST_CHECK_EQUAL(r2.path(), "/two");
+    BOOST_CHECK_MESSAGE(b.empty(), "both requests were consumed");
+}
+
+BOOST_AUTO_TEST_CASE(consume_outside_read)
+{
+    using namespace nx::tags;
+
+    nx::timer deadline;
+    nx::cond_var cv;
+
+    deadline(10) = [&](nx::timer& t) {
+        t.stop();
+        cv.notify();
+    };
+
+    deadline.start();
+
+    std::atomic<nx::tcp*> server{ nullptr };
+    std::atomic<nx::tcp*> client{ nullptr };
+    std::atomic_bool left{ false };
+    std::string second;
+
+    auto endpoint = nx::serve<nx::tcp>(
+        nx::make_endpoint_tcp("127.0.0.1", 0),
+        [&](nx::tcp& t) {
+            server = &t;
+        },
+        [&](nx::tcp& t) {
+            if (!left) {
+                // Consumed later, once the next read is pending
+                left = true;
+                return;
+            }
+
+            t >> second;
+
+            if (second.size() >= 6) {
+                deadline.stop();
+                cv.notify();
+            }
+        }
+    );
+
+    nx::connect<nx::tcp>(
+        endpoint,
+        [&](nx::tcp& t) {
+            client = &t;
+            t << "first";
+        }
+    );
+
+    nx::after(std::chrono::milliseconds(300)) << [&]() {
+        std::string first;
+
+        *server.load() >> first;
+        *client.load() << "second";
+    };
+
+    cv.wait();
+    nx::stop();
+
+    BOOST_CHECK_MESSAGE(left, "first input left unconsumed");
+    BOOST_CHECK_MESSAGE(second == "second", "later input read: " + second);
+}
@@ -0,0 +1,75 @@
+#define BOOST_TEST_MODULE router
+
+#include <iostream>
+#include <string>
+#include <deque>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/router.hpp>
+
+/*
+ * Routes are found by path segments: static segments first, then captures,
+ * then wildcards, backtracking when a branch leads nowhere. Equivalent
+ * routes are reported when added.
+ */
+
+const nx::route*
+find(const nx::router& r, const std::string& method, const std::string& path)
+{
+    nx::request req(method, path);
+
+    return r.find(req);
+}
+
+BOOST_AUTO_TEST_CASE(route_tree)
+{
+    using namespace nx;
+
+    std::deque<route> routes(7);
+
+    auto& root = routes[0];
+    auto& fixed = routes[1] / "items" / "new";
+    auto& item = routes[2] / "items" / ":id";
+    auto& sub = routes[3] / "items" / ":id" / "parts";
+    auto& deep = routes[4] / "items" / "new" / "draft";
+    auto& files = routes[5] / "files" / "*path";
+    auto& same = routes[6] / "items" / ":name";
+
+    router r;
+
+    BOOST_CHECK_MESSAGE(!r.add("GET", root), "root added");
+    BOOST_CHECK_MESSAGE(!r.add("GET", fixed), "static route added");
+    BOOST_CHECK_MESSAGE(!r.add("GET", item), "capture route added");
+    BOOST_CHECK_MESSAGE(!r.add("GET", sub), "nested capture route added");
+    BOOST_CHECK_MESSAGE(!r.add("GET", deep), "deep static route added");
+    BOOST_CHECK_MESSAGE(!r.add("GET", files), "wildcard route added");
+    BOOST_CHECK_MESSAGE(r.add("GET", same) == &item, "duplicate reported");
+    BOOST_CHECK_MESSAGE(!r.add("PUT", item), "same path on other method");
+
+    BOOST_CHECK_MESSAGE(find(r, "GET", "/") == &root, "root");
+    BOOST_CHECK_MESSAGE(find(r, "GET", "/items/new") == &fixed, "static first");
+    BOOST_CHECK_MESSAGE(find(r, "GET", "/items/new/") == &fixed, "trailing slash");
+    BOOST_CHECK_MESSAGE(find(r, "GET", "/items/12") == &item, "capture");
+    BOOST_CHECK_MESSAGE(
+        find(r, "GET", "/items/new/parts") == &sub,
+        "backtrack from static to capture"
+    );
+    BOOST_CHECK_MESSAGE(find(r, "GET", "/items/new/draft") == &deep, "deep static");
+    BOOST_CHECK_MESSAGE(find(r, "GET", "/files/a/b/c") == &files, "wildcard");
+    BOOST_CHECK_MESSAGE(find(r, "GET", "/files") == nullptr, "empty wildcard");
+    BOOST_CHECK_MESSAGE(find(r, "GET", "/items//12") == nullptr, "empty segment");
+    BOOST_CHECK_MESSAGE(find(r, "GET", "/other") == nullptr, "no route");
+    BOOST_CHECK_MESSAGE(find(r, "POST", "/items/12") == nullptr, "no method");
+    BOOST_CHECK_MESSAGE(find(r, "PUT", "/items/12") == &item, "other method");
+
+    request req("GET", "/items/12/parts");
+
+    BOOST_CHECK_MESSAGE(r.find(req) == &sub, "nested capture");
+    BOOST_CHECK_MESSAGE(req.a("id") == "12", "capture attribute");
+
+    request freq("GET", "/files/a/b/c");
+
+    BOOST_CHECK_MESSAGE(r.find(freq) == &files, "wildcard route");
+    BOOST_CHECK_MESSAGE(freq.a("path") == "a/b/c", "wildcard attribute");
+}
@@ -0,0 +1,100 @@
+#define BOOST_TEST_MODULE service
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/nx.hpp>
+#include <nx/utils.hpp>
+
+BOOST_AUTO_TEST_CASE(service_loops)
+{
+    using namespace nx;
+    using namespace std;
+
+    const std::size_t loops = 4;
+    const std::size_t clients = 8;
+
+    service::set_loop_count(loops);
+
+    BOOST_CHECK_MESSAGE(
+        service::get().loop_count() == loops,
+        "service runs the requested number of loops"
+    );
+
+    nx::timer deadline;
+    nx::cond_var cv;
+
+    deadline(5) = [&](nx::timer& t) {
+        t.stop();
+        cv.notify();
+    };
+
+    deadline.start();
+
+    std::mutex m;
+    std::set<std::thread::id> server_threads;
+    std::atomic_size_t replies{ 0 };
+    std::atomic_bool same_loop{ true };
+
+    httpd hd;
+
+    hd(GET) / "hello" = [&](const request& req, buffer& data, reply& rep) {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            server_threads.insert(std::this_thread::get_id());
+        }
+
+        auto io = current_loop();
+
+        async() << [&,io]() {
+            if (current_loop() != io) {
+                same_loop = false;
+            }
+        };
+
+        rep << text_plain << "hello";
+    };
+
+    auto sep = hd(make_endpoint("127.0.0.1", 0));
+
+    // Posted from outside the pool, run in order
+    std::vector<std::size_t> order;
+
+    for (std::size_t i = 0; i < 100; i++) {
+        async() << [&,i]() {
+            std::lock_guard<std::mutex> lock(m);
+            order.push_back(i);
+        };
+    }
+
+    for (std::size_t i = 0; i < clients; i++) {
+        httpc hc;
+        hc(GET, sep) / "hello" = [&](const reply& rep, buffer& data) {
+            if (++replies == clients) {
+                deadline.stop();
+                cv.notify();
+            }
+        };
+    }
+
+    cv.wait();
+    nx::stop();
+
+    BOOST_CHECK_MESSAGE(replies == clients, "all clients got a reply");
+    BOOST_CHECK_MESSAGE(
+        server_threads.size() > 1,
+        "connections were spread over several loops"
+    );
+    BOOST_CHECK_MESSAGE(same_loop, "async() posts to the calling loop");
+    BOOST_CHECK_MESSAGE(
+        order.size() == 100 && std::is_sorted(order.begin(), order.end()),
+        "async() from outside the pool runs in order"
+    );
+}
@@ -0,0 +1,89 @@
+#define BOOST_TEST_MODULE socket_options
+
+#include <iostream>
+#include <string>
+#include <atomic>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/nx.hpp>
+
+/*
+ * Listener options are inherited by accepted connections, client
+ * options apply before connecting.
+ */
+
+bool
+has_nodelay(nx::tcp& t)
+{
+    nx::asio::ip::tcp::no_delay o;
+    nx::error_code ec;
+
+    t.sock().get_option(o, ec);
+
+    return !ec && o.value();
+}
+
+BOOST_AUTO_TEST_CASE(socket_options)
+{
+    using namespace nx::tags;
+
+    nx::timer deadline;
+    nx::cond_var cv;
+
+    deadline(5) = [&](nx::timer& t) {
+        t.stop();
+        cv.notify();
+    };
+
+    deadline.start();
+
+    nx::socket_options o;
+    o.nodelay = true;
+
+    std::atomic_bool server_nodelay{ false };
+    std::atomic_bool client_nodelay{ false };
+    std::atomic_bool got_data{ false };
+
+    auto p = nx::new_object<nx::tcp>();
+    auto& server = *p;
+
+    server.options(o);
+
+    auto endpoint = nx::serve(
+        server,
+        nx::make_endpoint_tcp("127.0.0.1", 0),
+        [&](nx::tcp& t) {
+            server_nodelay = has_nodelay(t);
+        },
+        [&](nx::tcp& t) {
+            nx::buffer b;
+
+            t >> b;
+            got_data = true;
+            deadline.stop();
+            cv.notify();
+        }
+    );
+
+    auto c = nx::new_object<nx::tcp>();
+    auto& client = *c;
+
+    client.options(o);
+
+    nx::connect(
+        client,
+        endpoint,
+        [&](nx::tcp& t) {
+            client_nodelay = has_nodelay(t);
+            t.corked([&]() { t << "hello"; });
+        }
+    );
+
+    cv.wait();
+    nx::stop();
+
+    BOOST_CHECK_MESSAGE(server_nodelay, "accepted socket has TCP_NODELAY");
+    BOOST_CHECK_MESSAGE(client_nodelay, "connected socket has TCP_NODELAY");
+    BOOST_CHECK_MESSAGE(got_data, "corked write was received");
+}
@@ -0,0 +1,85 @@
+#define BOOST_TEST_MODULE strand
+
+#include <iostream>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/nx.hpp>
+#include <nx/utils.hpp>
+
+/*
+ * One event loop run by several threads, sockets serialize their
+ * handlers on strands.
+ */
+
+BOOST_AUTO_TEST_CASE(strand)
+{
+    using namespace nx;
+    using namespace std;
+
+    const std::size_t threads = 4;
+    const std::size_t clients = 16;
+
+    service::set_loop_count(1);
+    service::set_threads_per_loop(threads);
+
+    BOOST_CHECK_MESSAGE(
+        service::get().threads_per_loop() == threads,
+        "service runs the requested number of threads per loop"
+    );
+
+    nx::timer deadline;
+    nx::cond_var cv;
+
+    deadline(5) = [&](nx::timer& t) {
+        t.stop();
+        cv.notify();
+    };
+
+    deadline.start();
+
+    std::atomic_size_t requests{ 0 };
+    std::atomic_size_t replies{ 0 };
+    std::atomic_size_t good_replies{ 0 };
+
+    const std::string body(64 * 1024, 'x');
+
+    httpd hd;
+
+    hd(POST) / "echo" = [&](const request& req, buffer& data, reply& rep) {
+        requests++;
+
+        rep << text_plain << data;
+    };
+
+    auto sep = hd(make_endpoint("127.0.0.1", 0));
+
+    for (std::size_t i = 0; i < clients; i++) {
+        httpc hc;
+        hc(POST, sep)
+            / "echo"
+            << text_plain
+            << body
+            = [&](const reply& rep, buffer& data) {
+                if (rep && data == body) {
+                    good_replies++;
+                }
+
+                if (++replies == clients) {
+                    deadline.stop();
+                    cv.notify();
+                }
+            };
+    }
+
+    cv.wait();
+    nx::stop();
+
+    BOOST_CHECK_MESSAGE(requests == clients, "httpd got all requests");
+    BOOST_CHECK_MESSAGE(replies == clients, "all clients got a reply");
+    BOOST_CHECK_MESSAGE(good_replies == clients, "all replies are correct");
+}
@@ -0,0 +1,237 @@
+#define BOOST_TEST_MODULE streamed_body
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/nx.hpp>
+#include <nx/utils.hpp>
+
+/*
+ * Streamed request bodies reach their route in parts, with or without
+ * chunked transfer encoding, and may be paused by the handler. Chunked
+ * bodies sent to regular routes are decoded whole. A body resumed while
+ * the connection waits for input goes on with the input that follows.
+ */
+
+BOOST_AUTO_TEST_CASE(streamed_body)
+{
+    using namespace nx;
+    using namespace nx::tags;
+
+    nx::timer deadline;
+    nx::cond_var cv;
+
+    deadline(10) = [&](nx::timer& t) {
+        t.stop();
+        cv.notify();
+    };
+
+    deadline.start();
+
+    httpd hd;
+
+    std::size_t upload_size = 0;
+    std::size_t upload_parts = 0;
+    std::size_t max_part = 0;
+    bool paused = false;
+    std::string text;
+
+    hd(POST) / "upload" = body_stream{
+        [&](const request& req, buffer& chunk, reply& rep) {
+            upload_size += chunk.size();
+            upload_parts++;
+            max_part = std::max(max_part, chunk.size());
+
+            if (!paused) {
+                // Hold input for a while
+                paused = true;
+                rep.pause_body();
+
+                std::thread(
+                    [&]() {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                        rep.resume_body();
+                    }
+                ).detach();
+            }
+        },
+        [&](const request& req, buffer& data, reply& rep) {
+            rep << text_plain << "<upload " << upload_size << ">";
+        }
+    };
+
+    hd(POST) / "text" = body_stream{
+        [&](const request& req, buffer& chunk, reply& rep) {
+            text.append(chunk.begin(), chunk.end());
+        },
+        [&](const request& req, buffer& data, reply& rep) {
+            rep << text_plain << "<text " << text << ">";
+        }
+    };
+
+    hd(POST) / "echo" = [&](const request& req, buffer& data, reply& rep) {
+        rep << text_plain << "<echo " << std::string(data.begin(), data.end()) << ">";
+    };
+
+    auto sep = hd(make_endpoint("127.0.0.1"));
+
+    const std::size_t size = 4 * 1024 * 1024;
+
+    std::string received;
+    std::atomic_bool closed{ false };
+
+    auto c = nx::new_object<nx::tcp>();
+    auto& client = *c;
+
+    client[on_close] = [&](nx::tcp& t) {
+        closed = true;
+        cv.notify();
+    };
+
+    nx::connect(
+        client,
+        sep.ep_tcp,
+        [&](nx::tcp& t) {
+            t[on_read] = [&](nx::tcp& t) {
+                nx::buffer b;
+
+                t >> b;
+                received.append(b.begin(), b.end());
+            };
+
+            t
+                << "POST /upload HTTP/1.1\r\n"
+                << "Host: test\r\n"
+                << "Content-Length: " << std::to_string(size) << "\r\n"
+                << "\r\n"
+                << std::string(size, 'x')
+                << "POST /text HTTP/1.1\r\n"
+                << "Host: test\r\n"
+                << "Transfer-Encoding: chunked\r\n"
+                << "\r\n"
+                << "5\r\nhello\r\n"
+                << "6\r\n world\r\n"
+                << "0\r\n\r\n"
+                << "POST /echo HTTP/1.1\r\n"
+                << "Host: test\r\n"
+                << "Transfer-Encoding: chunked\r\n"
+                << "Connection: close\r\n"
+                << "\r\n"
+                << "3\r\nabc\r\n"
+                << "a\r\n0123456789\r\n"
+                << "0\r\n\r\n"
+                ;
+        }
+    );
+
+    cv.wait();
+
+    // Body resumed while the next read is pending
+    std::string parts;
+    bool parts_paused = false;
+
+    hd(POST) / "parts" = body_stream{
+        [&](const request& req, buffer& chunk, reply& rep) {
+            parts.append(chunk.begin(), chunk.end());
+
+            if (!parts_paused) {
+                parts_paused = true;
+                rep.pause_body();
+
+                nx::after(std::chrono::milliseconds(200)) << [&]() {
+                    rep.resume_body();
+                };
+            }
+        },
+        [&](const request& req, buffer& data, reply& rep) {
+            rep << text_plain << "<parts>";
+        }
+    };
+
+    std::string parts_received;
+    std::atomic_bool parts_closed{ false };
+
+    cv.reset();
+
+    auto p = nx::new_object<nx::tcp>();
+    auto& parts_client = *p;
+
+    parts_client[on_close] = [&](nx::tcp& t) {
+        parts_closed = true;
+        cv.notify();
+    };
+
+    nx::connect(
+        parts_client,
+        sep.ep_tcp,
+        [&](nx::tcp& t) {
+            t[on_read] = [&](nx::tcp& t) {
+                nx::buffer b;
+
+                t >> b;
+                parts_received.append(b.begin(), b.end());
+            };
+
+            t
+                << "POST /parts HTTP/1.1\r\n"
+                << "Host: test\r\n"
+                << "Content-Length: 6000\r\n"
+                << "Connection: close\r\n"
+                << "\r\n"
+                << std::string(1000, 'a')
+                ;
+        }
+    );
+
+    // Held while paused
+    nx::after(std::chrono::milliseconds(100)) << [&]() {
+        parts_client << std::string(2000, 'b');
+    };
+
+    // Sent once the body resumed and the connection is idle
+    nx::after(std::chrono::milliseconds(400)) << [&]() {
+        parts_client << std::string(3000, 'c');
+    };
+
+    cv.wait();
+    deadline.stop();
+    nx::stop();
+
+    auto count = [&](char c) {
+        return std::to_string(std::count(parts.begin(), parts.end(), c));
+    };
+
+    BOOST_CHECK_MESSAGE(parts_closed, "resumed body connection closed");
+    BOOST_CHECK_MESSAGE(
+        parts.size() == 6000
+        &&
+        parts == std::string(1000, 'a') + std::string(2000, 'b') + std::string(3000, 'c'),
+        "resumed body intact: a=" + count('a') + " b=" + count('b') + " c=" + count('c')
+    );
+    BOOST_CHECK_MESSAGE(
+        parts_received.find("<parts>") != std::string::npos,
+        "resumed body replied"
+    );
+
+    auto upload = received.find("<upload " + std::to_string(size) + ">");
+    auto text_reply = received.find("<text hello world>");
+    auto echo = received.find("<echo abc0123456789>");
+
+    BOOST_CHECK_MESSAGE(upload_size == size, "whole body streamed");
+    BOOST_CHECK_MESSAGE(upload_parts > 1, "body streamed in parts");
+    BOOST_CHECK_MESSAGE(max_part < size, "body never buffered whole");
+    BOOST_CHECK_MESSAGE(upload != std::string::npos, "upload replied");
+    BOOST_CHECK_MESSAGE(text_reply != std::string::npos, "chunked body streamed");
+    BOOST_CHECK_MESSAGE(echo != std::string::npos, "chunked body decoded");
+    BOOST_CHECK_MESSAGE(
+        upload < text_reply && text_reply < echo,
+        "replies in request order"
+    );
+    BOOST_CHECK_MESSAGE(closed, "connection closed on request");
+}
@@ -0,0 +1,146 @@
+#define BOOST_TEST_MODULE typed_route
+
+#include <iostream>
+#include <string>
+#include <deque>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/router.hpp>
+
+/*
+ * Typed route parameters are parsed from the captured path segments before
+ * the handler runs: text not fitting the type gives a NotFound, integers
+ * out of range a BadRequest.
+ */
+
+namespace shop {
+
+enum class color { red, green };
+
+bool
+parse_capture(nx::string_ref s, color& c)
+{
+    if (s == "red") {
+        c = color::red;
+    } else if (s == "green") {
+        c = color::green;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace shop
+
+int
+call(const nx::router& r, const std::string& path, std::string& out)
+{
+    nx::request req("GET", path);
+    nx::buffer data;
+    nx::reply rep;
+    auto* rt = r.find(req);
+
+    if (!rt) {
+        return 0;
+    }
+
+    try {
+        (*rt)(req, data, rep);
+    } catch (const nx::http_status& s) {
+        return s.code;
+    }
+
+    out = rep.h("X-Result");
+
+    return 200;
+}
+
+BOOST_AUTO_TEST_CASE(typed_params)
+{
+    using namespace nx;
+
+    std::deque<route> routes(4);
+
+    auto& item = routes[0] / "items" / param<int>("id") / "parts"
+        / param<std::uint8_t>("part") =
+        [](const request& req, buffer& data, reply& rep, int id, std::uint8_t part) {
+            rep << header{ "X-Result", std::to_string(id) + ":" + std::to_string(part) };
+        };
+
+    auto& object = routes[1] / "objects" / param<uuid>("id") =
+        [](const request& req, buffer& data, reply& rep, const uuid& id) {
+            rep << header{ "X-Result", id.str() };
+        };
+
+    auto& paint = routes[2] / "paint" / param<shop::color>("c")
+        / param<std::string>("name") =
+        [](const request& req, buffer& data, reply& rep, shop::color c, std::string name) {
+            rep << header{
+                "X-Result",
+                (c == shop::color::green ? "green " : "red ") + name
+            };
+        };
+
+    auto& plain = routes[3] / "plain" / ":name" =
+        [](const request& req, buffer& data, reply& rep) {
+            rep << header{ "X-Result", req.a("name") };
+        };
+
+    BOOST_CHECK_MESSAGE(item.typed(), "typed route");
+    BOOST_CHECK_MESSAGE(!plain.typed(), "untyped route");
+    BOOST_CHECK_MESSAGE(item.path() == "/items/:id/parts/:part", "typed path");
+
+    router r;
+
+    r.add("GET", item);
+    r.add("GET", object);
+    r.add("GET", paint);
+    r.add("GET", plain);
+
+    std::string out;
+
+    BOOST_CHECK_MESSAGE(call(r, "/items/12/parts/3", out) == 200, "integers");
+    BOOST_CHECK_MESSAGE(out == "12:3", "integer values");
+    BOOST_CHECK_MESSAGE(call(r, "/items/-7/parts/255", out) == 200, "limits");
+    BOOST_CHECK_MESSAGE(out == "-7:255", "limit values");
+    BOOST_CHECK_MESSAGE(call(r, "/items/x/parts/3", out) == 404, "not an integer");
+    BOOST_CHECK_MESSAGE(call(r, "/items/1/parts/-1", out) == 404, "not unsigned");
+    BOOST_CHECK_MESSAGE(call(r, "/items/1/parts/256", out) == 400, "out of range");
+    BOOST_CHECK_MESSAGE(
+        call(r, "/items/99999999999/parts/1", out) == 400,
+        "int out of range"
+    );
+
+    BOOST_CHECK_MESSAGE(
+        call(r, "/objects/0123abcd-4567-89ef-ABCD-0123456789ab", out) == 200,
+        "uuid"
+    );
+    BOOST_CHECK_MESSAGE(out == "0123abcd-4567-89ef-abcd-0123456789ab", "uuid value");
+    BOOST_CHECK_MESSAGE(
+        call(r, "/objects/0123abcd-4567-89ef-ABCD-0123456789a", out) == 404,
+        "short uuid"
+    );
+    BOOST_CHECK_MESSAGE(
+        call(r, "/objects/0123abcd+4567-89ef-ABCD-0123456789ab", out) == 404,
+        "bad uuid"
+    );
+
+    BOOST_CHECK_MESSAGE(call(r, "/paint/green/wall", out) == 200, "enum");
+    BOOST_CHECK_MESSAGE(out == "green wall", "enum value");
+    BOOST_CHECK_MESSAGE(call(r, "/paint/blue/wall", out) == 404, "unknown enum");
+
+    request req("GET", "/plain/text");
+
+    BOOST_CHECK_MESSAGE(r.find(req) == &plain, "plain route");
+    BOOST_CHECK_MESSAGE(req.a("name") == "text", "plain attribute");
+    BOOST_CHECK_MESSAGE(req.capture(0) == "text", "plain capture");
+
+    request treq("GET", "/items/1/parts/2");
+
+    r.find(treq);
+
+    BOOST_CHECK_MESSAGE(!treq.has_a("id"), "no attributes for typed routes");
+    BOOST_CHECK_MESSAGE(treq.capture_count() == 2, "typed captures");
+}
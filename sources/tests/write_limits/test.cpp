@@ -0,0 +1,90 @@
+#define BOOST_TEST_MODULE write_limits
+
+#include <iostream>
+#include <string>
+#include <atomic>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/nx.hpp>
+
+/*
+ * Server floods clients that don't read, write limits keep its queues
+ * bounded.
+ */
+
+BOOST_AUTO_TEST_CASE(write_limits)
+{
+    using namespace nx::tags;
+
+    const std::size_t chunk = 64 * 1024;
+    const std::size_t chunks = 1000;
+    const std::size_t max_bytes = 1024 * 1024;
+    const std::size_t max_frames = 8;
+
+    nx::timer deadline;
+    nx::cond_var cv(2);
+
+    deadline(5) = [&](nx::timer& t) {
+        t.stop();
+        cv.notify();
+        cv.notify();
+    };
+
+    deadline.start();
+
+    std::atomic_size_t connections{ 0 };
+    std::atomic_bool bytes_ok{ false };
+    std::atomic_bool frames_ok{ false };
+
+    auto endpoint = nx::serve<nx::tcp>(
+        nx::make_endpoint_tcp("127.0.0.1", 0),
+        [&](nx::tcp& t) {
+            if (connections++ == 0) {
+                t.write_limits(max_bytes, 0, nx::write_policy::drop_newest);
+
+                for (std::size_t i = 0; i < chunks; i++) {
+                    t << std::string(chunk, 'x');
+                }
+
+                bytes_ok =
+                    t.queued_bytes() <= max_bytes
+                    &&
+                    t.queued_bytes() + chunk > max_bytes;
+            } else {
+                t.write_limits(0, max_frames, nx::write_policy::drop_oldest);
+
+                for (std::size_t i = 0; i < chunks; i++) {
+                    t << std::string(chunk, 'y');
+                }
+
+                frames_ok =
+                    t.queued_frames() <= max_frames
+                    &&
+                    !t.writable();
+            }
+
+            cv.notify();
+        },
+        [&](nx::tcp& t) {
+        }
+    );
+
+    for (std::size_t i = 0; i < 2; i++) {
+        nx::connect<nx::tcp>(
+            endpoint,
+            [&](nx::tcp& t) {
+                // Stop reading early, never resume
+                t.read_watermarks(chunk, 0);
+            }
+        );
+    }
+
+    cv.wait();
+    deadline.stop();
+    nx::stop();
+
+    BOOST_CHECK_MESSAGE(connections == 2, "server got both connections");
+    BOOST_CHECK_MESSAGE(bytes_ok, "queued bytes are bounded");
+    BOOST_CHECK_MESSAGE(frames_ok, "queued frames are bounded");
+}
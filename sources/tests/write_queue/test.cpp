@@ -0,0 +1,104 @@
+#define BOOST_TEST_MODULE write_queue
+
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <nx/unit_test.hpp>
+
+#include <nx/write_queue.hpp>
+
+BOOST_AUTO_TEST_CASE(write_queue)
+{
+    const std::size_t producers = 4;
+    const std::size_t items = 10000;
+
+    nx::write_queue q;
+    std::vector<std::thread> threads;
+
+    BOOST_CHECK_MESSAGE(q.empty(), "new queue is empty");
+
+    for (std::size_t p = 0; p < producers; p++) {
+        threads.emplace_back(
+            [&q,p,items]() {
+                for (std::size_t i = 0; i < items; i++) {
+                    nx::buffer b(2);
+                    b[0] = (char) p;
+                    b[1] = (char) (i % 128);
+                    q.push(std::make_unique<nx::write_item>(std::move(b)));
+                }
+            }
+        );
+    }
+
+    std::vector<std::size_t> next(producers, 0);
+    std::size_t popped = 0;
+    bool ordered = true;
+
+    while (popped < producers * items) {
+        auto item = q.pop();
+
+        if (!item) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        auto p = (std::size_t) item->b[0];
+        auto i = (std::size_t) item->b[1];
+
+        ordered = ordered && (i == next[p] % 128);
+        next[p]++;
+        popped++;
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    BOOST_CHECK_MESSAGE(ordered, "items from one producer keep their order");
+    BOOST_CHECK_MESSAGE(!q.pop(), "nothing left to pop");
+    BOOST_CHECK_MESSAGE(q.empty(), "drained queue is empty");
+}
+
+BOOST_AUTO_TEST_CASE(write_queue_empty)
+{
+    const std::size_t producers = 4;
+    const std::size_t items = 10000;
+
+    nx::write_queue q;
+    std::vector<std::thread> threads;
+    std::atomic_size_t pushed{ 0 };
+
+    for (std::size_t p = 0; p < producers; p++) {
+        threads.emplace_back(
+            [&q,&pushed,items]() {
+                for (std::size_t i = 0; i < items; i++) {
+                    q.push(std::make_unique<nx::write_item>(nx::buffer(1)));
+                    pushed++;
+                }
+            }
+        );
+    }
+
+    std::size_t popped = 0;
+    bool consistent = true;
+
+    while (popped < producers * items) {
+        // Pushes done before the check can't be hidden, even half-linked
+        auto before = pushed.load();
+
+        if (q.pop()) {
+            popped++;
+        } else if (q.empty()) {
+            consistent = consistent && popped >= before;
+        }
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    BOOST_CHECK_MESSAGE(consistent, "empty queue holds no pushed item");
+    BOOST_CHECK_MESSAGE(q.empty(), "drained queue is empty");
+}